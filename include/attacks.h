@@ -0,0 +1,94 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include <cstdint>
+
+// Compilando com -DUSE_PEXT em x86-64 o binário tem os dois métodos de
+// indexação, e init() escolhe PEXT se a CPU tiver BMI2 ou os números mágicos
+// se não tiver. Sem -mbmi2 a instrução é escrita em assembly, para que só o
+// caminho escolhido em tempo de execução a use.
+#if defined(USE_PEXT) && defined(__x86_64__)
+#define ATTACKS_HAS_PEXT
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Attacks {
+
+#ifdef ATTACKS_HAS_PEXT
+// Escolhido em init(): true se a CPU suporta BMI2
+extern bool use_pext;
+
+// Extrai de bits os bits marcados em mask, juntos nos bits mais baixos
+inline uint64_t pext(uint64_t bits, uint64_t mask) {
+#ifdef __BMI2__
+    return _pext_u64(bits, mask);
+#else
+    uint64_t result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(bits), "r"(mask));
+    return result;
+#endif
+}
+#endif
+
+// Entrada da tabela de ataques de uma peça deslizante para uma casa.
+// O índice na tabela é obtido multiplicando as peças relevantes (mask) pelo
+// número mágico e deslocando o resultado (shift), o que mapeia cada
+// combinação de bloqueadores para uma posição única da tabela. Com PEXT, os
+// bits relevantes são extraídos diretamente e o número mágico não é usado.
+struct Magic {
+    uint64_t mask;      // Casas que podem bloquear a peça (sem as bordas)
+    uint64_t magic;     // Número mágico encontrado na inicialização
+    uint64_t* attacks;  // Início da fatia da tabela para esta casa
+    unsigned shift;     // 64 - número de bits da máscara
+
+    // Calcula o índice na tabela para uma ocupação do tabuleiro
+    inline unsigned index(uint64_t occupied) const {
+#ifdef ATTACKS_HAS_PEXT
+        if (use_pext) return unsigned(pext(occupied, mask));
+#endif
+        return unsigned(((occupied & mask) * magic) >> shift);
+    }
+};
+
+extern Magic rook_magics[64];
+extern Magic bishop_magics[64];
+
+// Casas estritamente entre duas casas alinhadas (0 se não estão alinhadas)
+extern uint64_t between_bb[64][64];
+
+// Linha inteira (de borda a borda) que passa por duas casas alinhadas,
+// incluindo as duas (0 se não estão alinhadas)
+extern uint64_t line_bb[64][64];
+
+// Inicializa as tabelas de ataques das peças deslizantes
+void init();
+
+// Nome do método de indexação em uso ("magic" ou "pext")
+const char* backend_name();
+
+// Retorna as casas atacadas por uma torre na casa dada, considerando a
+// ocupação do tabuleiro (a primeira peça de cada raio está incluída)
+inline uint64_t rook_attacks(int square, uint64_t occupied) {
+    const Magic& m = rook_magics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+// Retorna as casas atacadas por um bispo na casa dada
+inline uint64_t bishop_attacks(int square, uint64_t occupied) {
+    const Magic& m = bishop_magics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+// Retorna as casas atacadas por uma dama (união da torre e do bispo)
+inline uint64_t queen_attacks(int square, uint64_t occupied) {
+    return rook_attacks(square, occupied) | bishop_attacks(square, occupied);
+}
+
+inline uint64_t between(int a, int b) { return between_bb[a][b]; }
+inline uint64_t line(int a, int b) { return line_bb[a][b]; }
+
+}  // namespace Attacks
+
+#endif
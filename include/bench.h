@@ -0,0 +1,61 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "search.h"
+
+namespace Bench {
+
+// Mede a velocidade das consultas de ataques das peças deslizantes
+void attacks();
+
+// Compara make/undo incremental e copy-make no perft da posição inicial, até
+// a profundidade dada, e em uma busca alfa-beta simples (sem tabela de
+// transposição nem podas) nas posições do benchmark de busca, até
+// search_depth
+void make_modes(int depth, int search_depth);
+
+// Mede quantas posições por segundo são lidas (from_fen) e escritas
+// (to_fen). Usa as FENs do arquivo, uma por linha, ou, sem arquivo, posições
+// de partidas aleatórias geradas antes da medição.
+void fen(const char* path);
+
+// Compara a avaliação incremental (termos mantidos a cada movimento e
+// tabela de peões) com a mesma avaliação calculada do zero, em avaliações
+// por segundo, sobre posições de partidas aleatórias
+void eval();
+
+// Busca com os limites dados (profundidade e técnicas seletivas) em um
+// conjunto fixo de posições e mostra o total de nós e nós por segundo. O
+// total de nós só muda quando a busca muda, o que ajuda a conferir que uma
+// otimização não alterou o resultado.
+void search(Search::Limits limits);
+
+// Busca com os limites dados em posições táticas com solução conhecida e
+// mostra quantas foram resolvidas e o total de nós
+void tactics(Search::Limits limits);
+
+// Percorre todas as sequências de capturas (uma quiescência sem cortes) até
+// a profundidade dada nas posições da busca, gerando os movimentos de duas
+// formas: todos os legais filtrados depois e gen_captures direto. Mostra o
+// custo por nó de cada uma.
+void captures(int depth);
+
+// Em posições em xeque de partidas aleatórias, entrega todos os movimentos
+// pelo picker da busca principal (capturas e quietos) e pelo picker de
+// evasões e mostra o custo por nó de cada um
+void evasions();
+
+// Lazy SMP: repete a busca nas mesmas posições com 1, 2, 4... threads até
+// todos os núcleos e mostra o tempo até a profundidade e os nós/s de cada
+// contagem, com a aceleração em relação a uma thread
+void smp(int depth);
+
+// Partidas entre duas configurações da busca (A e B), a partir de aberturas
+// fixas jogadas com as duas cores. Com um limite de nós nas duas, o
+// resultado não depende da velocidade da máquina. Mostra o placar e a
+// diferença de Elo estimada de A.
+void selfplay(int games, const Search::Limits& a, const Search::Limits& b);
+
+}  // namespace Bench
+
+#endif
@@ -1,51 +1,290 @@
 #ifndef BOARD_H
 #define BOARD_H
 #include <cstdint>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "move.h"
+#include "psqt.h"
+#include "zobrist.h"
 
-enum Color { WHITE, BLACK };
+enum Color : uint8_t { WHITE, BLACK };
 
+// Peça com cor, usada no mailbox (uma peça por casa)
+enum Piece : uint8_t {
+    W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    NO_PIECE
+};
+
+// Monta a peça a partir da cor e do tipo (o tipo não pode ser NONE)
+inline Piece make_piece(Color color, PieceType type) {
+    return Piece(color * 6 + type);
+}
+
+// Tipo e cor de uma peça (a peça não pode ser NO_PIECE)
+inline PieceType type_of(Piece piece) { return PieceType(piece % 6); }
+inline Color color_of(Piece piece) { return Color(piece / 6); }
+
+// Casa inexistente, usada quando não há casa de en passant
+const int NO_SQUARE = 64;
+
+// Posição inicial do xadrez em FEN
+const char* const START_FEN =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Tamanho de buffer suficiente para qualquer FEN escrita por to_fen,
+// incluindo o terminador
+const int MAX_FEN_LENGTH = 128;
+
+// Maior profundidade de busca (em lances) a partir de uma posição
+const int MAX_PLY = 256;
+
+// Maior duração de partida prevista, em lances de cada jogador somados.
+// O histórico do Board é alocado para isso mais uma busca inteira.
+const int MAX_GAME_PLY = 1024;
+
+// Direitos de roque, um bit para cada lado de cada cor
+enum CastlingRights : uint8_t {
+    NO_CASTLING = 0,
+    WHITE_OO = 1,   // Roque pequeno das brancas
+    WHITE_OOO = 2,  // Roque grande das brancas
+    BLACK_OO = 4,   // Roque pequeno das pretas
+    BLACK_OOO = 8,  // Roque grande das pretas
+    ALL_CASTLING = 15
+};
+
+// Estado irreversível da posição antes de um movimento, salvo a cada lance
+// para que undo_move restaure tudo em O(1). Cabe em 8 bytes, então a pilha de
+// histórico ocupa pouco cache mesmo em buscas profundas. A chave Zobrist fica
+// em uma pilha separada (key_history).
 struct UndoInfo {
-    Move move;
-    PieceType captured_piece;
+    Move move;                  // 2 bytes
+    uint16_t halfmove_clock;    // Regra dos 50 lances antes do movimento
+    uint8_t captured_piece;     // PieceType capturado (NONE se nenhum)
+    uint8_t castling_rights;    // Direitos de roque antes do movimento
+    uint8_t en_passant_square;  // Casa de en passant antes (ou NO_SQUARE)
 };
 
-class Board {
-   public:
-    uint64_t white_pawns;
-    uint64_t black_pawns;
-    uint64_t white_king;
-    uint64_t black_king;
-    uint64_t white_knights;
-    uint64_t black_knights;
-    uint64_t white_rooks;
-    uint64_t black_rooks;
-    uint64_t white_bishops;
-    uint64_t black_bishops;
-    uint64_t white_queens;
-    uint64_t black_queens;
-
-    uint64_t white_occupied;
-    uint64_t black_occupied;
+static_assert(sizeof(UndoInfo) <= 8, "UndoInfo deve caber em 8 bytes");
+
+// Estado completo de uma posição, sem histórico. É trivialmente copiável, o
+// que permite o copy-make: copiar a posição para o próximo nível da pilha e
+// aplicar o movimento na cópia (ver PositionStack).
+//
+// Os bitboards e a chave ocupam as duas primeiras linhas de cache, o mailbox
+// a terceira e o restante do estado a quarta.
+struct alignas(64) Position {
+    // Bitboard de cada tipo de peça de cada cor: pieces[cor][tipo].
+    // Permite indexar por cor e tipo sem testar nada.
+    uint64_t pieces[2][6];
+
+    // Ocupação de cada cor e do tabuleiro inteiro
+    uint64_t occupied[2];
     uint64_t all_occupied;
 
+    // Chave Zobrist da posição, atualizada a cada movimento
+    uint64_t key;
+
+    // Peça em cada casa, mantida junto com os bitboards para saber qual peça
+    // está em uma casa com uma única leitura
+    Piece mailbox[64];
+
     Color turn;
 
-    Board();
+    // Direitos de roque ainda disponíveis (combinação de CastlingRights)
+    uint8_t castling_rights;
+
+    // Casa para onde um peão pode capturar en passant, ou NO_SQUARE. Só é
+    // marcada quando há um peão do oponente pronto para capturar, assim
+    // posições iguais têm sempre a mesma chave.
+    uint8_t en_passant_square;
+
+    // Lances desde a última captura ou movimento de peão (regra dos 50)
+    uint16_t halfmove_clock;
+
+    // Número do lance completo, incrementado depois de cada lance das pretas
+    uint16_t fullmove_number;
+
+    // Soma de PSQT::table (material e casas) de todas as peças, no
+    // meio-jogo e no final, do ponto de vista das brancas, e a fase do jogo.
+    // Atualizados junto com os bitboards, então a avaliação só os combina.
+    int16_t mg_score;
+    int16_t eg_score;
+    uint8_t phase;
+
+    // Chave Zobrist só dos peões (XOR das chaves de cada peão), que indexa a
+    // tabela de peões. Mantida junto com os bitboards, como a PSQT.
+    uint64_t pawn_key;
+
+    // Peça na casa (NO_PIECE se estiver vazia)
+    inline Piece piece_on(int square) const { return mailbox[square]; }
+
+    // Aplica um movimento de qualquer tipo (normal, promoção, en passant ou
+    // roque) sem guardar nada para desfazê-lo. O movimento precisa ser
+    // pseudo-legal; quem precisa voltar atrás guarda uma cópia antes.
+    void apply_move(const Move& move);
+
+    // Calcula a chave Zobrist do zero, a partir de todas as peças
+    uint64_t compute_key() const;
+
+    // Calcula mg_score, eg_score e phase do zero, percorrendo os bitboards
+    void compute_psqt(int& mg, int& eg, int& game_phase) const;
+
+    // Calcula a chave dos peões do zero
+    uint64_t compute_pawn_key() const;
 
-    
-    void make_move(const Move& move_to_apply);
+    // Lê a posição de uma FEN, preenchendo direto os bitboards, o mailbox e
+    // a chave. Os dois contadores de lances são opcionais (ambos ou
+    // nenhum). Não aloca memória. Retorna false, sem alterar a posição, se
+    // a FEN for inválida (formato, campos a mais, número de reis, peões na
+    // primeira ou última fileira, material impossível em uma partida — mais
+    // de 16 peças ou 8 peões de uma cor, ou mais peças promovidas do que
+    // peões faltando —, roque repetido ou sem rei ou torre na casa inicial,
+    // en passant impossível ou o lado que não joga em xeque).
+    bool from_fen(std::string_view fen);
+
+    // Escreve a FEN da posição no buffer (pelo menos MAX_FEN_LENGTH bytes),
+    // com terminador. Retorna o número de caracteres escritos.
+    int to_fen(char* buffer) const;
+
+   protected:
+    // Colocam, retiram e movem uma peça, mantendo bitboards, ocupações,
+    // mailbox, os termos da PSQT e a chave dos peões consistentes. A chave
+    // da posição é atualizada por quem chama.
+    inline void put_piece(Piece piece, int square) {
+        const uint64_t bit = 1ULL << square;
+        pieces[color_of(piece)][type_of(piece)] |= bit;
+        occupied[color_of(piece)] |= bit;
+        all_occupied |= bit;
+        mailbox[square] = piece;
+        mg_score += PSQT::table.mg[piece][square];
+        eg_score += PSQT::table.eg[piece][square];
+        phase += PSQT::table.phase[piece];
+        if (type_of(piece) == PAWN) {
+            pawn_key ^= Zobrist::piece_keys[color_of(piece)][PAWN][square];
+        }
+    }
+
+    inline void remove_piece(int square) {
+        const Piece piece = mailbox[square];
+        const uint64_t bit = 1ULL << square;
+        pieces[color_of(piece)][type_of(piece)] ^= bit;
+        occupied[color_of(piece)] ^= bit;
+        all_occupied ^= bit;
+        mailbox[square] = NO_PIECE;
+        mg_score -= PSQT::table.mg[piece][square];
+        eg_score -= PSQT::table.eg[piece][square];
+        phase -= PSQT::table.phase[piece];
+        if (type_of(piece) == PAWN) {
+            pawn_key ^= Zobrist::piece_keys[color_of(piece)][PAWN][square];
+        }
+    }
+
+    inline void move_piece(int from, int to) {
+        const Piece piece = mailbox[from];
+        const uint64_t from_to = (1ULL << from) | (1ULL << to);
+        pieces[color_of(piece)][type_of(piece)] ^= from_to;
+        occupied[color_of(piece)] ^= from_to;
+        all_occupied ^= from_to;
+        mailbox[from] = NO_PIECE;
+        mailbox[to] = piece;
+        mg_score += PSQT::table.mg[piece][to] - PSQT::table.mg[piece][from];
+        eg_score += PSQT::table.eg[piece][to] - PSQT::table.eg[piece][from];
+        if (type_of(piece) == PAWN) {
+            pawn_key ^= Zobrist::piece_keys[color_of(piece)][PAWN][from] ^
+                        Zobrist::piece_keys[color_of(piece)][PAWN][to];
+        }
+    }
+
+#ifdef DEBUG_HASH
+    void verify_key(const char* where) const;
+#endif
+};
+
+static_assert(std::is_trivially_copyable<Position>::value,
+              "Position precisa ser copiável com memcpy");
+static_assert(sizeof(Position) == 256, "Position deve ocupar 4 linhas");
+
+// Tabuleiro de jogo: a posição mais o histórico para desfazer movimentos
+// incrementalmente (make/undo). O histórico tem capacidade fixa, alocada uma
+// vez na construção, então fazer um movimento nunca realoca memória.
+class Board : public Position {
+   public:
+    explicit Board(int history_capacity = MAX_GAME_PLY + MAX_PLY);
+
+    // Aplicam e desfazem um movimento de qualquer tipo (normal, promoção,
+    // en passant ou roque). O movimento precisa ser pseudo-legal. Com o
+    // histórico cheio (ou sem peça do jogador na origem) o movimento é
+    // recusado e make_move retorna false, sem mostrar nada: quem chama
+    // informa o erro e não pode chamar undo_move, que desfaria o movimento
+    // anterior.
+    [[nodiscard]] bool make_move(const Move& move_to_apply);
     void undo_move();
 
+    // Passa a vez sem mover nenhuma peça (movimento nulo, usado na poda da
+    // busca). Não pode ser feito em xeque. A contagem da regra dos 50 lances
+    // recomeça, para que a busca de repetições não atravesse o lance nulo.
+    // Retorna false, sem alterar nada, com o histórico cheio.
+    [[nodiscard]] bool make_null_move();
+    void undo_null_move();
+
+    // Carrega uma posição FEN e limpa o histórico (ver Position::from_fen)
+    bool from_fen(std::string_view fen);
+
+    // Número de movimentos no histórico
+    inline int game_ply() const { return history_size; }
+
+    // Quantos movimentos ainda cabem no histórico
+    inline int free_plies() const {
+        return int(history.size()) - history_size;
+    }
+
+    // Verifica se a posição atual já ocorreu desde o último movimento
+    // irreversível (captura ou movimento de peão)
+    bool is_repetition() const;
+
     void print_board(const std::vector<int>& highlighted_squares = {}) const;
     void print_history() const;
 
    private:
     void init_board_state();
 
+    // Pilhas de capacidade fixa: só as history_size primeiras entradas são
+    // válidas. Um movimento além da capacidade é recusado.
     std::vector<UndoInfo> history;
+
+    // Chave de cada posição anterior, na mesma ordem do histórico. Fica
+    // separada para que a busca de repetições percorra só as chaves.
+    std::vector<uint64_t> key_history;
+
+    int history_size;
+};
+
+// Pilha pré-alocada de posições para copy-make, uma por thread. A posição
+// atual é o topo: fazer um movimento copia o topo para o nível seguinte e
+// aplica o movimento na cópia, e desfazer é só voltar um nível.
+class PositionStack {
+   public:
+    explicit PositionStack(const Position& root)
+        : states(MAX_PLY + 1), ply(0) {
+        states[0] = root;
+    }
+
+    inline Position& current() { return states[ply]; }
+    inline const Position& current() const { return states[ply]; }
+
+    inline void make_move(const Move& move) {
+        states[ply + 1] = states[ply];
+        states[++ply].apply_move(move);
+    }
+
+    inline void undo_move() { --ply; }
+
+   private:
+    std::vector<Position> states;
+    int ply;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include "board.h"
+#include "pawns.h"
+#include "psqt.h"
+
+namespace Eval {
+
+// Valor de cada tipo de peça em centipeões (o rei não é contado): o
+// material de meio-jogo da PSQT, para que as duas tabelas não divirjam
+inline constexpr const int (&PIECE_VALUES)[6] = PSQT::MG_VALUES;
+
+// Combina os termos de meio-jogo e final pela fase (promoções podem passar
+// de PSQT::MAX_PHASE, que é tratado como meio-jogo puro) e devolve o valor
+// do ponto de vista do jogador a mover
+inline int tapered(int mg, int eg, int phase, Color turn) {
+    if (phase > PSQT::MAX_PHASE) phase = PSQT::MAX_PHASE;
+    const int score =
+        (mg * phase + eg * (PSQT::MAX_PHASE - phase)) / PSQT::MAX_PHASE;
+    return (turn == WHITE) ? score : -score;
+}
+
+// Soma em mg e eg (do ponto de vista das brancas) a estrutura de peões, os
+// escudos dos reis, os peões passados livres e os cavalos em postos
+// avançados, a partir da entrada de peões da posição
+void add_pawn_terms(const Position& board, Pawns::Entry& entry, int& mg,
+                    int& eg);
+
+// Avalia a posição do ponto de vista do jogador a mover, em centipeões. A
+// estrutura de peões vem da tabela de peões da thread.
+int evaluate(const Position& board, Pawns::Table& pawns);
+
+}  // namespace Eval
+
+#endif
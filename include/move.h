@@ -1,10 +1,12 @@
 #ifndef MOVE_H
 #define MOVE_H
 
+#include <cassert>
 #include <cstdint>
 
-// Enum para os tipos de peças.
-enum PieceType { NONE, PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+// Enum para os tipos de peças. Começa em zero para indexar os bitboards
+// (Board::pieces[cor][tipo]); NONE indica ausência de peça.
+enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NONE };
 
 // Enum para as peças de promoção.
 enum PromotionType {
@@ -56,8 +58,52 @@ class Move {
     // Retorna o tipo de peça para promoção.
     inline int promotion_piece_type() const { return (data >> 14) & 0x3; }
 
+    // Os 16 bits do movimento, para guardar em tabelas
+    inline uint16_t raw() const { return data; }
+    static inline Move from_raw(uint16_t raw) {
+        Move move;
+        move.data = raw;
+        return move;
+    }
+
+    // Movimento vazio (a1a1), usado quando não há movimento
+    inline bool is_null() const { return data == 0; }
+
     // Sobrecarga do operador de igualdade para comparar dois movimentos.
     bool operator==(const Move& other) const { return data == other.data; }
 };
 
+// Lista de movimentos com capacidade fixa, guardada na pilha. Nenhuma posição
+// legal tem mais de 218 movimentos, então 256 é suficiente e os geradores
+// nunca precisam alocar memória. O limite vale porque Position::from_fen
+// recusa material impossível (por exemplo, 29 damas); o assert pega uma
+// posição que escape dessa verificação nas compilações de depuração.
+class MoveList {
+   private:
+    Move moves[256];
+    int count;
+
+   public:
+    MoveList() : count(0) {}
+
+    // Adiciona um movimento no final da lista
+    inline void push_back(const Move& move) {
+        assert(count < 256);
+        moves[count++] = move;
+    }
+
+    inline int size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline void clear() { count = 0; }
+
+    inline Move& operator[](int index) { return moves[index]; }
+    inline const Move& operator[](int index) const { return moves[index]; }
+
+    // Permitem usar a lista em laços "for (const Move& m : lista)"
+    inline Move* begin() { return moves; }
+    inline Move* end() { return moves + count; }
+    inline const Move* begin() const { return moves; }
+    inline const Move* end() const { return moves + count; }
+};
+
 #endif
\ No newline at end of file
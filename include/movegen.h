@@ -7,25 +7,66 @@
 #include "move.h"
 
 namespace MoveGen {
-    
-bool is_square_attacked(int square, Color attacker, const Board& board);
-    
-std::vector<Move> gen_white_pawn_moves(const Board& board);
-std::vector<Move> gen_white_king_moves(const Board& board);
-std::vector<Move> gen_black_pawn_moves(const Board& board);
-std::vector<Move> gen_black_king_moves(const Board& board);
-std::vector<Move> gen_white_knight_moves(const Board& board);
-std::vector<Move> gen_black_knight_moves(const Board& board);
-std::vector<Move> gen_white_rook_moves(const Board& board);
-std::vector<Move> gen_black_rook_moves(const Board& board);
-std::vector<Move> gen_white_bishop_moves(const Board& board);
-std::vector<Move> gen_black_bishop_moves(const Board& board);
-std::vector<Move> gen_white_queen_moves(const Board& board);
-std::vector<Move> gen_black_queen_moves(const Board& board);
-
-std::vector<Move> gen_all_moves(const Board& board);
-std::vector<Move> gen_legal_moves(Board& board);
 
+// Inicializa as tabelas de ataques (chamada automaticamente pelos geradores
+// de lista; chame antes de medir tempo para não contar a inicialização)
+void init_tables();
+
+// Verifica se a casa está atacada por alguma peça da cor Attacker
+template <Color Attacker>
+bool is_square_attacked(int square, const Position& board);
+bool is_square_attacked(int square, Color attacker, const Position& board);
+
+// Verifica se o rei do jogador a mover está em xeque
+bool in_check(const Position& board);
+
+// Cada gerador adiciona os movimentos da cor Us no final da lista recebida.
+// As duas cores são instanciadas em movegen.cpp.
+template <Color Us>
+void gen_pawn_moves(const Position& board, MoveList& moves);
+template <Color Us>
+void gen_king_moves(const Position& board, MoveList& moves);
+template <Color Us>
+void gen_knight_moves(const Position& board, MoveList& moves);
+template <Color Us>
+void gen_rook_moves(const Position& board, MoveList& moves);
+template <Color Us>
+void gen_bishop_moves(const Position& board, MoveList& moves);
+template <Color Us>
+void gen_queen_moves(const Position& board, MoveList& moves);
+
+// Movimentos pseudo-legais (podem deixar o próprio rei em xeque)
+void gen_all_moves(const Position& board, MoveList& moves);
+
+// Movimentos legais, gerados diretamente a partir das peças que dão xeque e
+// das peças cravadas, sem alterar o tabuleiro
+void gen_legal_moves(const Position& board, MoveList& moves);
+
+// Subconjuntos dos movimentos legais, gerados pelos mesmos geradores com os
+// destinos já restritos (nada é filtrado depois):
+// - gen_captures: capturas e promoções, inclusive en passant e promoções
+//   sem captura (a quiescência só olha estas);
+// - gen_quiets: todos os outros, inclusive roques;
+// - gen_evasions: as fugas do rei e as capturas ou bloqueios da peça que dá
+//   xeque. Só pode ser chamada com o rei em xeque (não tenta roques).
+// gen_captures e gen_quiets juntos dão exatamente gen_legal_moves.
+void gen_captures(const Position& board, MoveList& moves);
+void gen_quiets(const Position& board, MoveList& moves);
+void gen_evasions(const Position& board, MoveList& moves);
+
+// Verifica se um movimento qualquer (por exemplo, vindo da tabela de
+// transposição) é legal na posição, sem gerar a lista de movimentos
+bool is_legal(const Position& board, Move move);
+
+// Resultado material, em centipeões, da troca iniciada pelo movimento na
+// casa de destino, supondo que cada lado recaptura com a peça menos valiosa
+// e para quando continuar for pior (SEE). Negativo: a captura perde
+// material.
+int see(const Position& board, Move move);
+
+// Versões que alocam e retornam um vetor (usadas pela interface)
+std::vector<Move> gen_all_moves(const Position& board);
+std::vector<Move> gen_legal_moves(const Position& board);
 
 }  // namespace MoveGen
 
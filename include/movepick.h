@@ -0,0 +1,149 @@
+#ifndef MOVEPICK_H
+#define MOVEPICK_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "board.h"
+#include "move.h"
+
+// Movimento que não captura nem promove (os únicos que podem ser killers)
+inline bool is_quiet(const Position& board, Move move) {
+    return board.piece_on(move.to()) == NO_PIECE &&
+           move.type() != MoveType::PROMOTION &&
+           move.type() != MoveType::EN_PASSANT;
+}
+
+// Histórico "butterfly" dos movimentos quietos, por [cor][origem][destino]:
+// sobe quando o movimento causa corte e desce quando é tentado antes de
+// outro que corta. A atualização tem "gravidade": quanto mais perto do
+// limite, menor o efeito de cada bônus, então o valor nunca passa de
+// MAX_VALUE e movimentos antigos vão perdendo peso.
+class ButterflyHistory {
+   public:
+    static const int MAX_VALUE = 16384;
+
+    ButterflyHistory() { clear(); }
+
+    void clear() { std::memset(table, 0, sizeof(table)); }
+
+    inline int get(Color color, Move move) const {
+        return table[color][move.from()][move.to()];
+    }
+
+    // bonus entre -MAX_VALUE e MAX_VALUE
+    inline void update(Color color, Move move, int bonus) {
+        int16_t& entry = table[color][move.from()][move.to()];
+        entry += bonus - entry * std::abs(bonus) / MAX_VALUE;
+    }
+
+   private:
+    int16_t table[2][64][64];
+};
+
+// Contra-movimento: o movimento quieto que refutou a última vez cada
+// resposta, indexado pela peça que acabou de mover e pela casa onde ela
+// chegou
+class CounterMoveTable {
+   public:
+    inline Move get(Piece piece, int to) const { return table[piece][to]; }
+    inline void set(Piece piece, int to, Move move) {
+        table[piece][to] = move;
+    }
+
+   private:
+    Move table[12][64];
+};
+
+// Entrega os movimentos legais de um nó em etapas, na ordem em que costumam
+// causar corte:
+// 1. o movimento da tabela de transposição (ou da PV anterior);
+// 2. capturas e promoções que não perdem material (SEE >= 0), da vítima
+//    mais valiosa para o atacante menos valioso (MVV-LVA);
+// 3. killers e o contra-movimento;
+// 4. os demais movimentos quietos, pelo histórico;
+// 5. as capturas que perdem material.
+//
+// Na quiescência só as etapas 1 e 2 são usadas. Em xeque as etapas são
+// outras: o movimento da tabela e depois as evasões, geradas de uma vez por
+// MoveGen::gen_evasions (capturas por MVV-LVA, depois os quietos pelo
+// histórico, sem SEE).
+//
+// Cada etapa só é gerada quando é alcançada. Muitos nós terminam em corte já
+// no primeiro ou segundo movimento, e aí as etapas seguintes nem chegam a
+// ser geradas. Os movimentos das etapas 1 e 3 vêm de fora e são conferidos
+// com MoveGen::is_legal; as etapas seguintes não os repetem.
+class MovePicker {
+   public:
+    // killers aponta para dois movimentos (ou é nulo); movimentos vazios
+    // são ignorados. Sem histórico, os quietos vêm na ordem do gerador.
+    MovePicker(const Position& board, Move hash_move, const Move* killers,
+               Move counter_move, const ButterflyHistory* history = nullptr);
+
+    // Quiescência: só as capturas e promoções que não perdem material
+    MovePicker(const Position& board, Move hash_move);
+
+    // Nó em xeque (na busca principal ou na quiescência): todas as evasões
+    MovePicker(const Position& board, Move hash_move,
+               const ButterflyHistory* history);
+
+    // Próximo movimento, ou um movimento vazio quando não houver mais
+    Move next();
+
+   private:
+    enum Stage {
+        HASH_MOVE,
+        GEN_CAPTURES,
+        CAPTURES,
+        REFUTATIONS,
+        GEN_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        GEN_EVASIONS,
+        EVASIONS,
+        DONE
+    };
+
+    void score_captures();
+    void score_evasions();
+    void score_quiets();
+
+    // Traz para a posição current o movimento restante com a maior nota e
+    // o retorna (seleção parcial: um corte dispensa ordenar o resto)
+    Move pick_best();
+
+    // Captura que certamente não perde material (dispensa a SEE)
+    bool wins_material(Move move) const;
+
+    // Movimento já entregue por uma etapa anterior
+    bool already_tried(Move move) const;
+
+    const Position& board;
+    int stage;
+
+    Move hash_move;
+
+    // Killers e contra-movimento, na ordem em que são tentados
+    Move refutations[3];
+    int refutation_count = 0;
+    int refutation_index = 0;
+
+    // Na quiescência a geração termina depois das capturas
+    bool captures_only = false;
+
+    // Em xeque, depois do movimento da tabela vêm só as evasões
+    bool evasions = false;
+
+    const ButterflyHistory* history = nullptr;
+
+    MoveList moves;
+    int scores[256];
+    int current = 0;
+
+    // Capturas com SEE negativo, deixadas para o fim
+    MoveList bad_captures;
+    int bad_index = 0;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+namespace Pawns {
+
+// Avaliação da estrutura de peões de uma posição: peões passados, isolados,
+// dobrados e atrasados, do ponto de vista das brancas. Depende só dos peões,
+// então é guardada pela pawn_key e reaproveitada em todas as posições com
+// os mesmos peões. O escudo do rei depende também da casa do rei e é
+// recalculado só quando o rei sai da casa guardada.
+struct alignas(64) Entry {
+    uint64_t key;
+
+    // Casas que os peões de cada cor atacam ou podem vir a atacar avançando
+    // (fora delas, uma peça do oponente não pode ser expulsa por peões)
+    uint64_t attack_spans[2];
+
+    // Peões passados de cada cor (a avaliação dá um bônus a mais aos que
+    // têm a casa da frente livre)
+    uint64_t passed[2];
+
+    int16_t mg;
+    int16_t eg;
+
+    // Escudo de peões do rei de cada cor (só meio-jogo), válido enquanto o
+    // rei estiver em king_squares[cor]
+    int16_t shield[2];
+    uint8_t king_squares[2];
+
+    // Bônus do escudo do rei da cor dada, recalculado se o rei mudou de casa
+    int king_shield(Color color, const Position& board);
+};
+
+static_assert(sizeof(Entry) == 64, "Entry deve ocupar uma linha de cache");
+
+// Casas atacadas pelos peões da cor Us
+template <Color Us>
+inline uint64_t pawn_attacks(uint64_t pawns) {
+    const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;
+    const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;
+    if (Us == WHITE) {
+        return ((pawns & NOT_A_FILE) << 7) | ((pawns & NOT_H_FILE) << 9);
+    }
+    return ((pawns & NOT_A_FILE) >> 9) | ((pawns & NOT_H_FILE) >> 7);
+}
+
+// Preenche a entrada com a estrutura de peões da posição (sem consultar
+// nenhuma tabela)
+void evaluate(const Position& board, Entry& entry);
+
+// Tabela de peões de uma thread: sem escritas de outras threads, não precisa
+// de verificação nem de atomics. Substitui sempre a entrada antiga.
+class Table {
+   public:
+    explicit Table(size_t entry_count = DEFAULT_ENTRIES);
+
+    // Entrada com a estrutura de peões da posição, calculada e guardada se
+    // ainda não estiver na tabela
+    Entry& probe(const Position& board);
+
+    // Consultas e acertos, para a taxa de acerto nas estatísticas
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+    // 16384 entradas de 64 bytes: 1 MB por thread
+    static const size_t DEFAULT_ENTRIES = 16384;
+
+   private:
+    std::vector<Entry> entries;
+    size_t mask;
+};
+
+}  // namespace Pawns
+
+#endif
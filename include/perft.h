@@ -0,0 +1,79 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.h"
+
+namespace Perft {
+
+// Tabela hash com a contagem de nós de subárvores já visitadas, indexada
+// pela chave Zobrist da posição. O tamanho é arredondado para uma potência
+// de dois, então o índice é só um AND com a máscara.
+//
+// Cada entrada guarda os dados (profundidade e contagem) e o XOR deles com a
+// chave. Se duas threads escreverem na mesma entrada ao mesmo tempo, a
+// verificação do XOR falha na leitura e a entrada é ignorada, sem precisar
+// de travas. Com uma só thread o custo é o mesmo de uma tabela comum.
+class PerftTable {
+   public:
+    explicit PerftTable(size_t megabytes);
+
+    // Procura a contagem da posição na profundidade dada
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+
+    // Guarda a contagem, substituindo o que estiver na entrada
+    void store(uint64_t key, int depth, uint64_t nodes);
+
+    size_t size() const { return mask + 1; }
+
+   private:
+    struct Entry {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // nós << 8 | profundidade
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+};
+
+// Conta as posições folha da árvore de movimentos legais até a profundidade
+// dada. No último nível os movimentos são apenas contados, sem serem feitos.
+// Com uma tabela, subárvores repetidas (transposições) são contadas uma vez.
+// Se os movimentos não couberem no histórico do tabuleiro, mostra o erro e
+// retorna 0 em vez de uma contagem parcial (o mesmo vale para as funções
+// abaixo que recebem um Board).
+uint64_t perft(Board& board, int depth, PerftTable* table = nullptr);
+
+// Mesmo perft, mas com copy-make: cada nível copia a posição para uma pilha
+// pré-alocada e aplica o movimento na cópia, em vez de desfazer o movimento
+uint64_t perft_copy_make(const Position& root, int depth);
+
+// Perft dividido entre várias threads. Cada thread trabalha em uma cópia do
+// tabuleiro e as subárvores são distribuídas por filas com roubo de trabalho.
+// Retorna a contagem de cada movimento da raiz, na ordem de gen_legal_moves.
+// A tabela, se houver, é compartilhada entre as threads.
+std::vector<uint64_t> perft_parallel(const Board& board, int depth,
+                                     int threads,
+                                     PerftTable* table = nullptr);
+
+// Mostra a contagem de cada movimento da raiz e retorna o total
+uint64_t divide(Board& board, int depth, int threads = 1,
+                PerftTable* table = nullptr);
+
+// Roda perft (ou divide) e mostra nós, tempo e nós por segundo. Com
+// hash_megabytes > 0 usa uma tabela hash desse tamanho.
+void run(Board& board, int depth, bool show_divide, int threads = 1,
+         size_t hash_megabytes = 0);
+
+// Roda a bateria de posições de referência. Retorna true se todas as
+// contagens baterem com os valores esperados.
+bool run_suite();
+
+}  // namespace Perft
+
+#endif
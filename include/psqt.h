@@ -0,0 +1,35 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include <cstdint>
+
+namespace PSQT {
+
+// Material de cada tipo de peça no meio-jogo e no final (o rei não é
+// contado). No final os peões e as torres valem um pouco mais e as peças
+// menores um pouco menos. Os valores de meio-jogo são também os da SEE, da
+// ordenação das capturas e da poda delta (Eval::PIECE_VALUES).
+inline constexpr int MG_VALUES[6] = {100, 320, 330, 500, 900, 0};
+inline constexpr int EG_VALUES[6] = {120, 300, 320, 520, 950, 0};
+
+// Valor de cada peça em cada casa, já somado ao material, do ponto de vista
+// das brancas (as peças pretas têm valores negativos), no meio-jogo (mg) e
+// no final (eg). A soma sobre todas as peças do tabuleiro é mantida na
+// posição a cada movimento, como a chave Zobrist.
+struct Table {
+    int16_t mg[12][64];  // [peça][casa]
+    int16_t eg[12][64];
+
+    // Peso de cada peça na fase do jogo: cavalos e bispos 1, torres 2 e
+    // damas 4. Com todas as peças iniciais a soma é MAX_PHASE.
+    uint8_t phase[12];
+};
+
+extern const Table table;
+
+// Fase da posição inicial (meio-jogo puro); 0 é um final só com peões
+const int MAX_PHASE = 24;
+
+}  // namespace PSQT
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <cstdint>
+
+#include "board.h"
+#include "move.h"
+#include "tt.h"
+
+namespace Search {
+
+// Pontuações em centipeões. Um mate em n lances vale MATE_SCORE - n (do
+// ponto de vista de quem dá o mate); qualquer valor acima de MATE_BOUND é
+// um mate.
+const int INFINITE_SCORE = 32000;
+const int MATE_SCORE = 31000;
+const int MATE_BOUND = MATE_SCORE - MAX_PLY;
+
+// Técnicas seletivas da busca. Cada uma pode ser desligada para medir o
+// efeito dela nos nós até a profundidade e na força (partidas com número
+// fixo de nós).
+struct Selectivity {
+    bool null_move = true;         // Poda do movimento nulo
+    bool lmr = true;               // Redução dos lances tardios
+    bool reverse_futility = true;  // Corte pela avaliação estática
+    bool futility = true;          // Poda de lances quietos sem chance
+    bool razoring = true;          // Quiescência direto perto das folhas
+
+    // Redução da LMR: lmr_base + ln(profundidade) * ln(lance) / lmr_divisor
+    double lmr_base = 0.75;
+    double lmr_divisor = 2.25;
+};
+
+// Limites da busca. Sem tempo definido, a busca vai até a profundidade.
+struct Limits {
+    int depth = 64;
+    int64_t movetime_ms = 0;  // 0 = sem limite de tempo
+    uint64_t nodes = 0;       // 0 = sem limite de nós
+    int threads = 1;          // Threads do Lazy SMP
+    bool verbose = true;      // Mostra uma linha a cada iteração
+    Selectivity selectivity;
+};
+
+// Resultado da última iteração completa
+struct Result {
+    Move best_move;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    double tt_hit_rate = 0.0;  // Fração das consultas encontradas na tabela
+    int hashfull = 0;          // Ocupação da tabela em milésimos
+
+    // Fração dos cortes beta causados pelo primeiro movimento tentado, uma
+    // medida da qualidade da ordenação
+    double first_move_cutoff_rate = 0.0;
+
+    // Fração das avaliações com a estrutura de peões já na tabela de peões
+    double pawn_hit_rate = 0.0;
+};
+
+// Procura o melhor movimento com aprofundamento iterativo e PVS (negamax
+// alfa-beta fail-soft). A tabela de transposição é mantida entre buscas.
+//
+// Com mais de uma thread usa Lazy SMP: cada thread busca em sua cópia do
+// tabuleiro, as auxiliares em profundidades intercaladas, e todas
+// compartilham a tabela. Quando a thread principal termina (ou o tempo
+// acaba), todas param e o movimento é escolhido por votação.
+Result run(const Board& board, const Limits& limits, TranspositionTable& tt);
+
+}  // namespace Search
+
+#endif
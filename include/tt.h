@@ -0,0 +1,88 @@
+#ifndef TT_H
+#define TT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "move.h"
+
+// Tipo do limite guardado: o valor exato, um limite superior (nenhum
+// movimento passou de alfa) ou inferior (corte beta)
+enum Bound : uint8_t { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+// Conteúdo de uma entrada, já decodificado
+struct TTEntry {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Tabela de transposição compartilhada por todas as threads da busca,
+// indexada pela chave Zobrist.
+//
+// Cada balde tem 4 entradas de 16 bytes e ocupa exatamente uma linha de
+// cache, então uma consulta lê só uma linha. Como na PerftTable, cada entrada
+// guarda os dados e o XOR deles com a chave: uma escrita simultânea de duas
+// threads só faz a verificação falhar na leitura, sem travas.
+//
+// A substituição prefere manter entradas profundas e da busca atual: cada
+// busca nova incrementa a geração, e entradas de gerações antigas perdem
+// valor a cada geração.
+class TranspositionTable {
+   public:
+    // huge_pages pede ao sistema páginas de 2 MB (madvise, só no Linux), o
+    // que reduz as falhas de TLB em tabelas grandes
+    explicit TranspositionTable(size_t megabytes, bool huge_pages = false);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Apaga todas as entradas
+    void clear();
+
+    // Marca o início de uma busca nova (as entradas atuais envelhecem)
+    void new_search() { generation = uint8_t(generation + 1); }
+
+    // Procura a posição. Retorna false se ela não estiver na tabela.
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    // Guarda o resultado de uma busca. Sem movimento (Move()), mantém o
+    // movimento que já estava guardado para a mesma posição. Um limite
+    // (não exato) bem mais raso que o já guardado para a mesma posição não
+    // o substitui: só renova a geração e o movimento.
+    void store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+    // Traz o balde da posição para o cache antes de ele ser consultado
+    inline void prefetch(uint64_t key) const {
+        __builtin_prefetch(&buckets[key & mask]);
+    }
+
+    // Ocupação em milésimos, estimada pelas entradas da busca atual nos
+    // primeiros baldes
+    int hashfull() const;
+
+    size_t size() const { return (mask + 1) * BUCKET_SIZE; }
+
+   private:
+    static const int BUCKET_SIZE = 4;
+
+    struct Entry {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // Campos compactados (ver tt.cpp)
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+
+    static_assert(sizeof(Bucket) == 64, "Bucket deve ocupar uma linha");
+
+    Bucket* buckets;
+    size_t mask;
+    uint8_t generation;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <string>
+
+#include "move.h"
+
+// Converte o índice de uma casa (0-63) para a notação algébrica ("e4")
+std::string square_to_algebraic(int square_index);
+
+// Converte a notação algébrica ("e4") para o índice da casa, ou -1 se inválida
+int algebraic_to_square(const std::string& square_notation);
+
+// Converte um movimento para a notação de coordenadas ("e2e4", "e7e8q")
+std::string move_to_string(const Move& move);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+namespace Zobrist {
+
+// Chaves aleatórias de cada componente da posição. A chave de uma posição é
+// o XOR das chaves de tudo que está presente nela, o que permite atualizá-la
+// com poucos XORs a cada movimento.
+extern uint64_t piece_keys[2][6][64];  // [cor][tipo de peça][casa]
+extern uint64_t side_key;              // Presente quando as pretas jogam
+extern uint64_t castling_keys[16];     // Uma por combinação de roques
+extern uint64_t en_passant_keys[8];    // Uma por coluna de en passant
+
+// Preenche as chaves (pode ser chamada várias vezes, só inicializa uma vez)
+void init();
+
+}  // namespace Zobrist
+
+#endif
@@ -0,0 +1,215 @@
+#include "attacks.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace Attacks {
+
+Magic rook_magics[64];
+Magic bishop_magics[64];
+uint64_t between_bb[64][64];
+uint64_t line_bb[64][64];
+
+#ifdef ATTACKS_HAS_PEXT
+bool use_pext = false;
+#endif
+
+// Tabelas de ataques compartilhadas por todas as casas. Cada casa usa uma
+// fatia de tamanho 2^(bits da máscara), somando 102400 entradas para as torres
+// e 5248 para os bispos.
+static uint64_t rook_table[102400];
+static uint64_t bishop_table[5248];
+
+// Direções (fileira, coluna) das peças deslizantes
+static const int rook_directions[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+static const int bishop_directions[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Gerador pseudoaleatório (xorshift64*) com semente fixa, para que os números
+// mágicos encontrados sejam sempre os mesmos a cada execução
+class Prng {
+   public:
+    explicit Prng(uint64_t seed) : state(seed) {}
+
+    uint64_t rand64() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Número com poucos bits ligados, bons candidatos a número mágico
+    uint64_t sparse_rand64() { return rand64() & rand64() & rand64(); }
+
+   private:
+    uint64_t state;
+};
+
+// Calcula os ataques de uma peça deslizante andando casa a casa em cada
+// direção. É lento, por isso só é usado para preencher as tabelas.
+static uint64_t sliding_attacks(int square, uint64_t occupied,
+                                const int directions[4][2]) {
+    uint64_t attacks = 0ULL;
+
+    for (int d = 0; d < 4; ++d) {
+        int rank = square / 8 + directions[d][0];
+        int file = square % 8 + directions[d][1];
+
+        // Desliza até sair do tabuleiro ou encontrar uma peça
+        while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+            uint64_t bit = 1ULL << (rank * 8 + file);
+            attacks |= bit;
+            if (occupied & bit) break;
+
+            rank += directions[d][0];
+            file += directions[d][1];
+        }
+    }
+
+    return attacks;
+}
+
+// Encontra os números mágicos e preenche a tabela de ataques de um tipo de
+// peça deslizante
+static void init_magics(Magic magics[64], uint64_t* table,
+                        const int directions[4][2]) {
+    const uint64_t RANK_1 = 0x00000000000000FFULL;
+    const uint64_t RANK_8 = 0xFF00000000000000ULL;
+    const uint64_t FILE_A = 0x0101010101010101ULL;
+    const uint64_t FILE_H = 0x8080808080808080ULL;
+
+    // Todas as combinações de bloqueadores de uma casa e seus ataques
+    static uint64_t occupancy[4096];
+    static uint64_t reference[4096];
+
+    // Marca em qual tentativa cada posição da tabela foi escrita, evitando
+    // limpar a tabela a cada número mágico testado
+    static int epoch[4096];
+    static int attempt = 0;
+
+    // Sementes por fileira que encontram números mágicos rapidamente
+    const uint64_t seeds[8] = {728,   10316, 55013, 32803,
+                               12281, 15100, 16645, 255};
+
+    uint64_t* next_slice = table;
+
+    for (int square = 0; square < 64; ++square) {
+        Magic& m = magics[square];
+
+        // As bordas não influenciam os ataques (a peça na borda é sempre
+        // atacada), exceto as bordas onde a própria peça está
+        const uint64_t rank_bb = RANK_1 << (8 * (square / 8));
+        const uint64_t file_bb = FILE_A << (square % 8);
+        const uint64_t edges =
+            ((RANK_1 | RANK_8) & ~rank_bb) | ((FILE_A | FILE_H) & ~file_bb);
+
+        m.mask = sliding_attacks(square, 0ULL, directions) & ~edges;
+        m.shift = 64 - __builtin_popcountll(m.mask);
+        m.attacks = next_slice;
+
+        // Percorre todos os subconjuntos da máscara (Carry-Rippler)
+        int size = 0;
+        uint64_t subset = 0ULL;
+        do {
+            occupancy[size] = subset;
+            reference[size] = sliding_attacks(square, subset, directions);
+            size++;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        next_slice += size;
+
+#ifdef ATTACKS_HAS_PEXT
+        // Com PEXT o índice de cada ocupação já é único, basta preencher
+        if (use_pext) {
+            m.magic = 0ULL;
+            for (int i = 0; i < size; ++i) {
+                m.attacks[m.index(occupancy[i])] = reference[i];
+            }
+            continue;
+        }
+#endif
+
+        // Testa números aleatórios até achar um sem colisões destrutivas
+        // (duas ocupações com ataques diferentes no mesmo índice)
+        Prng prng(seeds[square / 8]);
+        for (int i = 0; i < size;) {
+            m.magic = 0ULL;
+            while (__builtin_popcountll((m.magic * m.mask) >> 56) < 6) {
+                m.magic = prng.sparse_rand64();
+            }
+
+            ++attempt;
+            for (i = 0; i < size; ++i) {
+                unsigned idx = m.index(occupancy[i]);
+
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Preenche as tabelas de casas entre duas casas e de linhas completas
+static void init_lines() {
+    for (int a = 0; a < 64; ++a) {
+        for (int b = 0; b < 64; ++b) {
+            between_bb[a][b] = 0ULL;
+            line_bb[a][b] = 0ULL;
+            if (a == b) continue;
+
+            const uint64_t a_bit = 1ULL << a;
+            const uint64_t b_bit = 1ULL << b;
+
+            // Testa as duas famílias de direções (retas e diagonais)
+            const int(*families[2])[2] = {rook_directions, bishop_directions};
+            for (const auto& directions : families) {
+                if (!(sliding_attacks(a, 0ULL, directions) & b_bit)) continue;
+
+                // O cruzamento dos ataques de cada casa, com a outra casa
+                // bloqueando, é exatamente o trecho entre as duas
+                between_bb[a][b] = sliding_attacks(a, b_bit, directions) &
+                                   sliding_attacks(b, a_bit, directions);
+
+                // A linha é o cruzamento dos ataques no tabuleiro vazio
+                line_bb[a][b] = (sliding_attacks(a, 0ULL, directions) &
+                                 sliding_attacks(b, 0ULL, directions)) |
+                                a_bit | b_bit;
+            }
+        }
+    }
+}
+
+// Inicializa as tabelas de ataques das peças deslizantes
+void init() {
+#ifdef __BMI2__
+    // Compilado com -mbmi2 (ou -march=native), o compilador pode usar BMI2
+    // em qualquer lugar, não só no PEXT. Melhor avisar do que terminar com
+    // uma instrução ilegal mais adiante.
+    if (!__builtin_cpu_supports("bmi2")) {
+        std::cerr << "Erro: este binário foi compilado para BMI2, que esta "
+                     "CPU não suporta. Recompile sem -mbmi2/-march=native."
+                  << std::endl;
+        std::exit(1);
+    }
+#endif
+#ifdef ATTACKS_HAS_PEXT
+    use_pext = __builtin_cpu_supports("bmi2");
+#endif
+
+    init_magics(rook_magics, rook_table, rook_directions);
+    init_magics(bishop_magics, bishop_table, bishop_directions);
+    init_lines();
+}
+
+const char* backend_name() {
+#ifdef ATTACKS_HAS_PEXT
+    if (use_pext) return "pext";
+#endif
+    return "magic";
+}
+
+}  // namespace Attacks
@@ -0,0 +1,820 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "attacks.h"
+#include "board.h"
+#include "eval.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "pawns.h"
+#include "perft.h"
+#include "search.h"
+#include "utils.h"
+
+namespace Bench {
+
+// Mede a velocidade das consultas de ataques das peças deslizantes.
+// O checksum deve ser igual para qualquer método de indexação (magic/pext),
+// o que também serve para conferir que as tabelas estão corretas.
+void attacks() {
+    MoveGen::init_tables();
+
+    // Sorteia as casas e ocupações antes de medir, para que o laço medido
+    // faça apenas as consultas
+    const int SAMPLES = 4096;
+    const int ROUNDS = 20000;
+    static int squares[SAMPLES];
+    static uint64_t occupancies[SAMPLES];
+
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    for (int i = 0; i < SAMPLES; ++i) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        uint64_t r1 = seed * 2685821657736338717ULL;
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        uint64_t r2 = seed * 2685821657736338717ULL;
+
+        squares[i] = int(r1 & 63);
+        occupancies[i] = r1 & r2;  // ~25% das casas ocupadas
+    }
+
+    uint64_t checksum = 0ULL;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (int i = 0; i < SAMPLES; ++i) {
+            checksum += Attacks::rook_attacks(squares[i], occupancies[i]);
+            checksum += Attacks::bishop_attacks(squares[i], occupancies[i]);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double lookups = 2.0 * SAMPLES * ROUNDS;
+
+    std::cout << "Backend: " << Attacks::backend_name() << std::endl;
+    std::cout << "Consultas: " << uint64_t(lookups) << std::endl;
+    std::cout << "Tempo: " << seconds << " s" << std::endl;
+    std::cout << "ns/consulta: " << (seconds * 1e9 / lookups) << std::endl;
+    std::cout << "Mconsultas/s: " << (lookups / seconds / 1e6) << std::endl;
+    std::cout << "Checksum: " << checksum << std::endl;
+}
+
+// Mede uma das formas de fazer e desfazer movimentos no perft e mostra o
+// resultado em uma linha
+template <typename PerftFunction>
+static uint64_t time_perft(const char* name, PerftFunction run_perft) {
+    auto start = std::chrono::steady_clock::now();
+    const uint64_t nodes = run_perft();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << name << ": " << nodes << " nós, " << seconds << " s, "
+              << uint64_t(nodes / seconds / 1e3) << " knós/s" << std::endl;
+    return nodes;
+}
+
+// Gera FENs jogando partidas com movimentos legais sorteados a partir da
+// posição inicial, guardando cada posição visitada
+static std::vector<std::string> random_game_fens(int count) {
+    std::vector<std::string> fens;
+    fens.reserve(count);
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    char buffer[MAX_FEN_LENGTH];
+    Board board;
+    MoveList moves;
+
+    while (int(fens.size()) < count) {
+        moves.clear();
+        MoveGen::gen_legal_moves(board, moves);
+
+        // Fim de partida ou partida longa demais: começa outra
+        if (moves.empty() || board.game_ply() >= 200) {
+            board.from_fen(START_FEN);
+            continue;
+        }
+
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        const uint64_t r = seed * 2685821657736338717ULL;
+
+        if (!board.make_move(moves[int(r % uint64_t(moves.size()))])) {
+            board.from_fen(START_FEN);
+            continue;
+        }
+        board.to_fen(buffer);
+        fens.push_back(buffer);
+    }
+
+    return fens;
+}
+
+void fen(const char* path) {
+    std::vector<std::string> fens;
+    if (path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Erro: não foi possível abrir " << path << std::endl;
+            return;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) fens.push_back(line);
+        }
+    } else {
+        fens = random_game_fens(1000000);
+    }
+
+    if (fens.empty()) {
+        std::cerr << "Erro: nenhuma FEN para medir" << std::endl;
+        return;
+    }
+
+    // As posições lidas ficam guardadas para medir a escrita em seguida
+    std::vector<Position> positions(fens.size());
+    std::vector<char> valid(fens.size());
+    size_t parsed = 0;
+    uint64_t checksum = 0ULL;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fens.size(); ++i) {
+        valid[i] = positions[i].from_fen(fens[i]);
+        if (valid[i]) {
+            ++parsed;
+            checksum ^= positions[i].key;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    const double parse_seconds =
+        std::chrono::duration<double>(end - start).count();
+
+    char buffer[MAX_FEN_LENGTH];
+    uint64_t characters = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fens.size(); ++i) {
+        if (valid[i]) characters += positions[i].to_fen(buffer);
+    }
+    end = std::chrono::steady_clock::now();
+    const double write_seconds =
+        std::chrono::duration<double>(end - start).count();
+
+    // Ida e volta: a FEN escrita deve ser igual à lida (pode diferir em
+    // arquivos com casa de en passant sem captura possível, que é removida)
+    size_t different = 0;
+    for (size_t i = 0; i < fens.size(); ++i) {
+        if (!valid[i]) continue;
+        positions[i].to_fen(buffer);
+        if (fens[i] != buffer) ++different;
+    }
+
+    std::cout << "Posições: " << fens.size() << " (" << parsed
+              << " válidas)" << std::endl;
+    std::cout << "from_fen: " << parse_seconds << " s, "
+              << uint64_t(fens.size() / parse_seconds) << " posições/s"
+              << std::endl;
+    std::cout << "to_fen: " << write_seconds << " s, "
+              << uint64_t(parsed / write_seconds) << " posições/s"
+              << std::endl;
+    std::cout << "Diferentes na ida e volta: " << different << std::endl;
+    std::cout << "Checksum: " << checksum << " (" << characters
+              << " caracteres)" << std::endl;
+}
+
+// Avaliação a partir do zero: PSQT percorrendo os bitboards e estrutura de
+// peões calculada a cada chamada, sem a tabela de peões
+static int evaluate_from_scratch(const Position& board) {
+    int mg, eg, phase;
+    board.compute_psqt(mg, eg, phase);
+
+    Pawns::Entry entry;
+    Pawns::evaluate(board, entry);
+    Eval::add_pawn_terms(board, entry, mg, eg);
+    return Eval::tapered(mg, eg, phase, board.turn);
+}
+
+// Chama a avaliação passes vezes em cada posição e retorna o tempo. A soma
+// dos valores vai para checksum, para que o laço não seja descartado.
+template <typename EvalFunction>
+static double time_evaluations(const std::vector<Position>& positions,
+                               int passes, EvalFunction evaluate,
+                               int64_t& checksum) {
+    checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const Position& position : positions) {
+            checksum += evaluate(position);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void eval() {
+    const std::vector<std::string> fens = random_game_fens(100000);
+    std::vector<Position> positions(fens.size());
+    for (size_t i = 0; i < fens.size(); ++i) positions[i].from_fen(fens[i]);
+
+    const int passes = 50;
+    const double evaluations = double(positions.size()) * passes;
+    int64_t incremental_sum, scratch_sum;
+    Pawns::Table pawn_table;
+    const double incremental_seconds = time_evaluations(
+        positions, passes,
+        [&pawn_table](const Position& position) {
+            return Eval::evaluate(position, pawn_table);
+        },
+        incremental_sum);
+    const double scratch_seconds = time_evaluations(
+        positions, passes, evaluate_from_scratch, scratch_sum);
+
+    std::cout << "Avaliações: " << uint64_t(evaluations) << " ("
+              << positions.size() << " posições)" << std::endl;
+    std::cout << "Incremental: "
+              << uint64_t(evaluations / incremental_seconds)
+              << " avaliações/s" << std::endl;
+    std::cout << "Do zero: " << uint64_t(evaluations / scratch_seconds)
+              << " avaliações/s" << std::endl;
+    std::cout << "Acertos na tabela de peões: "
+              << 100.0 * pawn_table.hits / pawn_table.probes << "%"
+              << std::endl;
+    std::cout << "Somas "
+              << (incremental_sum == scratch_sum ? "iguais" : "DIFERENTES")
+              << " (" << incremental_sum << ")" << std::endl;
+}
+
+// Posições do benchmark de busca: abertura, meio-jogo tático e finais
+static const char* const SEARCH_POSITIONS[] = {
+    START_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "2r3k1/pp3ppp/2n1b3/3p4/3P4/2N1BN2/PP3PPP/2R3K1 b - - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",
+};
+
+// Os dois modos de fazer e desfazer movimentos, com a mesma interface, para
+// a busca de comparação abaixo. O histórico do Board tem espaço para MAX_PLY
+// movimentos além da partida, e a busca não passa desse nível.
+class MakeUndoMode {
+   public:
+    explicit MakeUndoMode(const char* fen) { board.from_fen(fen); }
+
+    const Position& current() const { return board; }
+
+    void make_move(Move move) {
+        const bool made = board.make_move(move);
+        assert(made);
+        (void)made;
+    }
+    void undo_move() { board.undo_move(); }
+
+   private:
+    Board board;
+};
+
+class CopyMakeMode {
+   public:
+    explicit CopyMakeMode(const Position& root) : stack(root) {}
+
+    const Position& current() const { return stack.current(); }
+
+    void make_move(Move move) { stack.make_move(move); }
+    void undo_move() { stack.undo_move(); }
+
+   private:
+    PositionStack stack;
+};
+
+// Quiescência da busca de comparação: avaliação parada e capturas que não
+// perdem material, ou todas as evasões em xeque
+template <typename Mode>
+static int quiescence_with(Mode& mode, Pawns::Table& pawns, int alpha,
+                           int beta, int ply, uint64_t& nodes) {
+    ++nodes;
+    const Position& position = mode.current();
+    const bool in_check = MoveGen::in_check(position);
+
+    int best = -Search::INFINITE_SCORE;
+    if (!in_check) {
+        best = Eval::evaluate(position, pawns);
+        if (best >= beta || ply >= MAX_PLY - 1) return best;
+        alpha = std::max(alpha, best);
+    }
+
+    MovePicker picker = in_check ? MovePicker(position, Move(), nullptr)
+                                 : MovePicker(position, Move());
+    int count = 0;
+    for (Move move = picker.next(); !move.is_null(); move = picker.next()) {
+        ++count;
+        mode.make_move(move);
+        const int score =
+            -quiescence_with(mode, pawns, -beta, -alpha, ply + 1, nodes);
+        mode.undo_move();
+
+        if (score > best) {
+            best = score;
+            if (score >= beta) break;
+            alpha = std::max(alpha, score);
+        }
+    }
+
+    if (in_check && count == 0) return -Search::MATE_SCORE + ply;
+    return best;
+}
+
+// Alfa-beta simples, sem tabela de transposição nem podas, para comparar os
+// modos na busca: os dois visitam exatamente os mesmos nós e só diferem em
+// como os movimentos são feitos e desfeitos
+template <typename Mode>
+static int alpha_beta_with(Mode& mode, Pawns::Table& pawns, int alpha,
+                           int beta, int depth, int ply, uint64_t& nodes) {
+    if (depth == 0) {
+        return quiescence_with(mode, pawns, alpha, beta, ply, nodes);
+    }
+    ++nodes;
+
+    const Position& position = mode.current();
+    const bool in_check = MoveGen::in_check(position);
+    MovePicker picker =
+        in_check ? MovePicker(position, Move(), nullptr)
+                 : MovePicker(position, Move(), nullptr, Move());
+
+    int best = -Search::INFINITE_SCORE;
+    int count = 0;
+    for (Move move = picker.next(); !move.is_null(); move = picker.next()) {
+        ++count;
+        mode.make_move(move);
+        const int score = -alpha_beta_with(mode, pawns, -beta, -alpha,
+                                           depth - 1, ply + 1, nodes);
+        mode.undo_move();
+
+        if (score > best) {
+            best = score;
+            if (score >= beta) break;
+            alpha = std::max(alpha, score);
+        }
+    }
+
+    if (count == 0) return in_check ? -Search::MATE_SCORE + ply : 0;
+    return best;
+}
+
+// Roda a busca de comparação em todas as posições da busca com um dos modos
+// e mostra o resultado em uma linha. Retorna a soma das pontuações, que deve
+// ser a mesma nos dois modos.
+template <typename MakeMode>
+static int64_t time_search_mode(const char* name, int depth,
+                                MakeMode make_mode) {
+    uint64_t nodes = 0;
+    int64_t score_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const char* fen : SEARCH_POSITIONS) {
+        auto mode = make_mode(fen);
+        Pawns::Table pawns;
+        score_sum += alpha_beta_with(mode, pawns, -Search::INFINITE_SCORE,
+                                     Search::INFINITE_SCORE, depth, 0, nodes);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << name << ": " << nodes << " nós, " << seconds << " s, "
+              << uint64_t(nodes / seconds / 1e3) << " knós/s" << std::endl;
+    return score_sum;
+}
+
+void make_modes(int depth, int search_depth) {
+    MoveGen::init_tables();
+
+    std::cout << "sizeof(Position): " << sizeof(Position)
+              << " bytes, sizeof(UndoInfo): " << sizeof(UndoInfo) << " bytes"
+              << std::endl;
+
+    std::cout << "Perft, profundidade " << depth << std::endl;
+    Board board;
+    const uint64_t make_undo = time_perft(
+        "make/undo", [&] { return Perft::perft(board, depth); });
+    const uint64_t copy_make = time_perft(
+        "copy-make", [&] { return Perft::perft_copy_make(board, depth); });
+
+    if (make_undo != copy_make) {
+        std::cerr << "Erro: as contagens dos dois modos são diferentes"
+                  << std::endl;
+    }
+
+    std::cout << "Busca alfa-beta, profundidade " << search_depth
+              << std::endl;
+    const int64_t make_undo_sum =
+        time_search_mode("make/undo", search_depth,
+                         [](const char* fen) { return MakeUndoMode(fen); });
+    const int64_t copy_make_sum =
+        time_search_mode("copy-make", search_depth, [](const char* fen) {
+            Position root;
+            root.from_fen(fen);
+            return CopyMakeMode(root);
+        });
+
+    if (make_undo_sum != copy_make_sum) {
+        std::cerr << "Erro: as buscas dos dois modos são diferentes"
+                  << std::endl;
+    }
+}
+
+void search(Search::Limits limits) {
+    limits.verbose = false;
+
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    double total_cutoff_rate = 0.0;
+    double total_pawn_hit_rate = 0.0;
+    int positions = 0;
+    TranspositionTable tt(16);
+
+    for (const char* fen : SEARCH_POSITIONS) {
+        Board board;
+        board.from_fen(fen);
+
+        // Cada posição começa com a tabela vazia, para que o total de nós
+        // não dependa da ordem das posições
+        tt.clear();
+        const Search::Result result = Search::run(board, limits, tt);
+        total_nodes += result.nodes;
+        total_seconds += result.seconds;
+        total_cutoff_rate += result.first_move_cutoff_rate;
+        total_pawn_hit_rate += result.pawn_hit_rate;
+        ++positions;
+
+        std::cout << move_to_string(result.best_move) << " score "
+                  << result.score << " nós " << result.nodes << " corte1 "
+                  << int(result.first_move_cutoff_rate * 100) << "%  " << fen
+                  << std::endl;
+    }
+
+    std::cout << std::endl << "Nós: " << total_nodes << std::endl;
+    std::cout << "Cortes no primeiro movimento: "
+              << total_cutoff_rate / positions * 100 << "% (média)"
+              << std::endl;
+    std::cout << "Acertos na tabela de peões: "
+              << total_pawn_hit_rate / positions * 100 << "% (média)"
+              << std::endl;
+    std::cout << "Tempo: " << total_seconds << " s" << std::endl;
+    if (total_seconds > 0) {
+        std::cout << "Nós/s: " << uint64_t(total_nodes / total_seconds)
+                  << std::endl;
+    }
+}
+
+// Posições táticas (Win At Chess 1 a 10) e o melhor movimento de cada uma
+struct TacticalPosition {
+    const char* fen;
+    const char* best_move;
+};
+
+static const TacticalPosition TACTICAL_POSITIONS[] = {
+    {"2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1", "g3g6"},
+    {"8/7p/5k2/5p2/p1p2P2/Pr1pPK2/1P1R3P/8 b - - 0 1", "b3b2"},
+    {"5rk1/1ppb3p/p1pb4/6q1/3P1p1r/2P1R2P/PP1BQ1P1/5RKN w - - 0 1", "e3g3"},
+    {"r1bq2rk/pp3pbp/2p1p1pQ/7P/3P4/2PB1N2/PP3PPR/2KR4 w - - 0 1", "h6h7"},
+    {"5k2/6pp/p1qN4/1p1p4/3P4/2PKP2Q/PP3r2/3R4 b - - 0 1", "c6c4"},
+    {"7k/p7/1R5K/6r1/6p1/6P1/8/8 w - - 0 1", "b6b7"},
+    {"rnbqkb1r/pppp1ppp/8/4P3/6n1/7P/PPPNPPP1/R1BQKBNR b KQkq - 0 1", "g4e3"},
+    {"r4q1k/p2bR1rp/2p2Q1N/5p2/5p2/2P5/PP3PPP/R5K1 w - - 0 1", "e7f7"},
+    {"3q1rk1/p4pp1/2pb3p/3p4/6Pr/1PNQ4/P1PB1PP1/4RRK1 b - - 0 1", "d6h2"},
+    {"2br2k1/2q3rn/p2NppQ1/2p1P3/Pp5R/4P3/1P3PPP/3R2K1 w - - 0 1", "h4h7"},
+};
+
+void tactics(Search::Limits limits) {
+    limits.verbose = false;
+
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    int solved = 0;
+    TranspositionTable tt(16);
+
+    for (const TacticalPosition& position : TACTICAL_POSITIONS) {
+        Board board;
+        board.from_fen(position.fen);
+
+        tt.clear();
+        const Search::Result result = Search::run(board, limits, tt);
+        total_nodes += result.nodes;
+        total_seconds += result.seconds;
+
+        const std::string move = move_to_string(result.best_move);
+        const bool found = move == position.best_move;
+        solved += found;
+
+        std::cout << (found ? "ok   " : "erro ") << move << " (esperado "
+                  << position.best_move << ") nós " << result.nodes << "  "
+                  << position.fen << std::endl;
+    }
+
+    const int count =
+        int(sizeof(TACTICAL_POSITIONS) / sizeof(TACTICAL_POSITIONS[0]));
+    std::cout << std::endl
+              << "Resolvidas: " << solved << "/" << count << std::endl;
+    std::cout << "Nós: " << total_nodes << std::endl;
+    std::cout << "Tempo: " << total_seconds << " s" << std::endl;
+}
+
+// Percorre todas as sequências de capturas a partir da posição, como uma
+// quiescência sem cortes. Com FilterAll gera todos os movimentos legais e
+// descarta os quietos; sem, usa gen_captures. Retorna o número de nós.
+template <bool FilterAll>
+static uint64_t capture_tree(Board& board, int depth) {
+    MoveList moves;
+    if (FilterAll) {
+        MoveList all;
+        MoveGen::gen_legal_moves(board, all);
+        for (const Move& move : all) {
+            if (!is_quiet(board, move)) moves.push_back(move);
+        }
+    } else {
+        MoveGen::gen_captures(board, moves);
+    }
+
+    if (depth == 0) return 1;
+
+    uint64_t nodes = 1;
+    for (const Move& move : moves) {
+        if (!board.make_move(move)) continue;
+        nodes += capture_tree<FilterAll>(board, depth - 1);
+        board.undo_move();
+    }
+    return nodes;
+}
+
+template <bool FilterAll>
+static double time_capture_trees(int depth, uint64_t& nodes) {
+    nodes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const char* fen : SEARCH_POSITIONS) {
+        Board board;
+        board.from_fen(fen);
+        nodes += capture_tree<FilterAll>(board, depth);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+void captures(int depth) {
+    MoveGen::init_tables();
+
+    uint64_t filtered_nodes = 0;
+    uint64_t direct_nodes = 0;
+    const double filtered_seconds =
+        time_capture_trees<true>(depth, filtered_nodes);
+    const double direct_seconds =
+        time_capture_trees<false>(depth, direct_nodes);
+
+    // As duas árvores precisam ser iguais, senão a comparação não vale
+    std::cout << "Nós: " << direct_nodes;
+    if (filtered_nodes != direct_nodes) {
+        std::cout << " (diferente da filtragem: " << filtered_nodes << ")";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Todos os legais + filtro: " << filtered_seconds << " s, "
+              << filtered_seconds * 1e9 / filtered_nodes << " ns/nó"
+              << std::endl;
+    std::cout << "gen_captures: " << direct_seconds << " s, "
+              << direct_seconds * 1e9 / direct_nodes << " ns/nó" << std::endl;
+    if (direct_seconds > 0) {
+        std::cout << "Aceleração: " << filtered_seconds / direct_seconds
+                  << "x" << std::endl;
+    }
+}
+
+// Entrega todos os movimentos de cada posição pelo picker da busca
+// principal (Evasions = false, capturas e quietos em etapas, com SEE) ou
+// pelo picker de evasões. Retorna o tempo; o total de movimentos vai para
+// moves.
+template <bool Evasions>
+static double time_pickers(const std::vector<Position>& positions,
+                           int passes, uint64_t& moves) {
+    moves = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const Position& position : positions) {
+            MovePicker picker =
+                Evasions ? MovePicker(position, Move(), nullptr)
+                         : MovePicker(position, Move(), nullptr, Move());
+            while (!picker.next().is_null()) ++moves;
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+void evasions() {
+    // Posições em xeque de partidas aleatórias
+    std::vector<Position> positions;
+    for (const std::string& fen : random_game_fens(1000000)) {
+        Position position;
+        position.from_fen(fen);
+        if (MoveGen::in_check(position)) positions.push_back(position);
+    }
+    if (positions.empty()) {
+        std::cerr << "Erro: nenhuma posição em xeque" << std::endl;
+        return;
+    }
+
+    const int passes = 20;
+    uint64_t staged_moves = 0, evasion_moves = 0;
+    const double staged_seconds =
+        time_pickers<false>(positions, passes, staged_moves);
+    const double evasion_seconds =
+        time_pickers<true>(positions, passes, evasion_moves);
+    const double nodes = double(positions.size()) * passes;
+
+    std::cout << "Posições em xeque: " << positions.size() << std::endl;
+    std::cout << "Movimentos: " << evasion_moves / passes;
+    if (staged_moves != evasion_moves) {
+        std::cout << " (diferente das etapas: " << staged_moves / passes
+                  << ")";
+    }
+    std::cout << std::endl;
+    std::cout << "Capturas + quietos: " << staged_seconds << " s, "
+              << staged_seconds * 1e9 / nodes << " ns/nó" << std::endl;
+    std::cout << "Evasões: " << evasion_seconds << " s, "
+              << evasion_seconds * 1e9 / nodes << " ns/nó" << std::endl;
+    if (evasion_seconds > 0) {
+        std::cout << "Aceleração: " << staged_seconds / evasion_seconds
+                  << "x" << std::endl;
+    }
+}
+
+void smp(int depth) {
+    Search::Limits limits;
+    limits.depth = depth;
+    limits.verbose = false;
+
+    // 1, 2, 4... threads, terminando sempre com todos os núcleos
+    const int cores = std::max(1, int(std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < cores; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(cores);
+
+    TranspositionTable tt(64);
+    double base_seconds = 0.0;
+    double base_nps = 0.0;
+
+    std::cout << "Núcleos: " << cores << ", profundidade " << depth
+              << std::endl;
+
+    for (int threads : thread_counts) {
+        limits.threads = threads;
+
+        uint64_t total_nodes = 0;
+        double total_seconds = 0.0;
+        for (const char* fen : SEARCH_POSITIONS) {
+            Board board;
+            board.from_fen(fen);
+
+            tt.clear();
+            const Search::Result result = Search::run(board, limits, tt);
+            total_nodes += result.nodes;
+            total_seconds += result.seconds;
+        }
+
+        const double nps = total_seconds > 0 ? total_nodes / total_seconds
+                                             : 0.0;
+        if (threads == 1) {
+            base_seconds = total_seconds;
+            base_nps = nps;
+        }
+
+        // Aceleração do tempo até a profundidade e escala dos nós/s,
+        // ambos em relação a uma thread
+        std::cout << threads << " threads: " << total_seconds << " s, "
+                  << uint64_t(nps) << " nós/s, aceleração "
+                  << (total_seconds > 0 ? base_seconds / total_seconds : 0.0)
+                  << "x, nós/s " << (base_nps > 0 ? nps / base_nps : 0.0)
+                  << "x" << std::endl;
+    }
+}
+
+// Aberturas das partidas de teste, cada uma jogada com as duas cores
+static const char* const OPENINGS[] = {
+    START_FEN,
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 0 2",
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "rnbqkbnr/pppp1ppp/8/4p3/2P5/8/PP1PPPPP/RNBQKBNR w KQkq - 0 2",
+    "rnbqkbnr/ppp2ppp/4p3/3p4/3PP3/8/PPP2PPP/RNBQKBNR w KQkq - 0 3",
+    "rnbqkbnr/pp2pppp/2p5/3p4/3PP3/8/PPP2PPP/RNBQKBNR w KQkq - 0 3",
+    "rnbqkb1r/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKB1R w KQkq - 2 2",
+};
+
+// Partidas mais longas que isso são declaradas empate
+const int MAX_GAME_LENGTH = 300;
+
+// Sem peões, torres ou damas e com no máximo uma peça menor, ninguém
+// consegue dar mate
+static bool insufficient_material(const Position& board) {
+    uint64_t heavy = 0ULL;
+    uint64_t minors = 0ULL;
+    for (int color = WHITE; color <= BLACK; ++color) {
+        heavy |= board.pieces[color][PAWN] | board.pieces[color][ROOK] |
+                 board.pieces[color][QUEEN];
+        minors |= board.pieces[color][KNIGHT] | board.pieces[color][BISHOP];
+    }
+    return !heavy && __builtin_popcountll(minors) <= 1;
+}
+
+// Joga uma partida a partir da abertura. Retorna 1 se as brancas vencerem,
+// -1 se as pretas vencerem e 0 no empate.
+static int play_game(const char* opening, const Search::Limits& white,
+                     const Search::Limits& black, TranspositionTable& white_tt,
+                     TranspositionTable& black_tt) {
+    Board board;
+    board.from_fen(opening);
+    white_tt.clear();
+    black_tt.clear();
+
+    for (int ply = 0; ply < MAX_GAME_LENGTH; ++ply) {
+        MoveList moves;
+        MoveGen::gen_legal_moves(board, moves);
+        if (moves.empty()) {
+            if (!MoveGen::in_check(board)) return 0;
+            return (board.turn == WHITE) ? -1 : 1;
+        }
+        if (board.halfmove_clock >= 100 || board.is_repetition() ||
+            insufficient_material(board)) {
+            return 0;
+        }
+
+        const bool white_to_move = board.turn == WHITE;
+        const Search::Result result =
+            Search::run(board, white_to_move ? white : black,
+                        white_to_move ? white_tt : black_tt);
+        if (!board.make_move(result.best_move)) return 0;
+    }
+    return 0;
+}
+
+void selfplay(int games, const Search::Limits& a, const Search::Limits& b) {
+    Search::Limits first = a;
+    Search::Limits second = b;
+    first.verbose = second.verbose = false;
+
+    TranspositionTable first_tt(16);
+    TranspositionTable second_tt(16);
+
+    const int openings = int(sizeof(OPENINGS) / sizeof(OPENINGS[0]));
+    int wins = 0, draws = 0, losses = 0;
+
+    for (int game = 0; game < games; ++game) {
+        // Cada abertura é jogada duas vezes seguidas, trocando as cores
+        const char* opening = OPENINGS[(game / 2) % openings];
+        const bool first_is_white = game % 2 == 0;
+
+        const int result =
+            first_is_white
+                ? play_game(opening, first, second, first_tt, second_tt)
+                : -play_game(opening, second, first, second_tt, first_tt);
+        if (result > 0) ++wins;
+        if (result == 0) ++draws;
+        if (result < 0) ++losses;
+
+        const char* outcome = (result > 0)   ? "A vence"
+                              : (result < 0) ? "B vence"
+                                             : "empate";
+        std::cout << "Partida " << game + 1 << ": " << outcome << "  (A "
+                  << wins << " / empates " << draws << " / B " << losses
+                  << ")" << std::endl;
+    }
+
+    // Diferença de Elo estimada a partir da pontuação de A
+    const double score = (wins + 0.5 * draws) / std::max(1, games);
+    std::cout << std::endl << "Pontuação de A: " << score * 100 << "%";
+    if (score > 0.0 && score < 1.0) {
+        const double elo = 400.0 * std::log10(score / (1.0 - score));
+        std::cout << " (Elo " << elo << ")";
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace Bench
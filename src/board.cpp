@@ -4,8 +4,18 @@
 #include <iostream>
 #include <vector>
 
-// Construtor da classe Board
-Board::Board() { init_board_state(); }
+#include "movegen.h"
+#include "zobrist.h"
+
+// Caracteres de cada peça na ordem do enum Piece (maiúsculas = brancas)
+static const char PIECE_CHARS[] = "PNBRQKpnbrqk";
+
+// Construtor da classe Board. O histórico é alocado aqui, de uma vez.
+Board::Board(int history_capacity)
+    : history(history_capacity), key_history(history_capacity),
+      history_size(0) {
+    init_board_state();
+}
 
 // Inicializa o estado do tabuleiro com a posição inicial padrão do xadrez
 void Board::init_board_state() {
@@ -15,7 +25,7 @@ void Board::init_board_state() {
     // ...
     // 11111111  <- Peças
     // 00000000
-    white_pawns = 0x000000000000FF00ULL;
+    pieces[WHITE][PAWN] = 0x000000000000FF00ULL;
 
     // Os peões pretos começam na fileira 7
     // Correspondem aos índices 48 a 55
@@ -23,411 +33,758 @@ void Board::init_board_state() {
     // 11111111  <- Peças
     // ...
     // 00000000
-    black_pawns = 0x00FF000000000000ULL;
+    pieces[BLACK][PAWN] = 0x00FF000000000000ULL;
 
     // O rei branco começa na casa e1, correspondente ao índice 4
     // 00000000
     // ...
     // 00010000  <- Peças
-    white_king = (1ULL << 4);
+    pieces[WHITE][KING] = (1ULL << 4);
 
     // O rei preto começa na casa e8, correspondente ao índice 60
     // 00001000 <-  Peças
     // ...
     // 00000000
-    black_king = (1ULL << 60);
+    pieces[BLACK][KING] = (1ULL << 60);
 
     // Os cavalos brancos começam nas casas b1 e g1
     // Correspondem aos índices 1 e 6
     // 00000000
     // ...
     // 01000010 <-  Peças
-    white_knights = (1ULL << 1) | (1ULL << 6);
+    pieces[WHITE][KNIGHT] = (1ULL << 1) | (1ULL << 6);
 
     // Os cavalos pretos começam nas casas b8 e g8
     // Correspondem aos índices 57 e 62
     // 01000010 <- Peças
     // ...
     // 00000000
-    black_knights = (1ULL << 57) | (1ULL << 62);
+    pieces[BLACK][KNIGHT] = (1ULL << 57) | (1ULL << 62);
 
     // As torres brancas começam nas casas a1 e h1
     // Correspondem aos índices 0 e 7
     // 00000000
     // ...
     // 10000001 <- Peças
-    white_rooks = (1ULL << 0) | (1ULL << 7);
+    pieces[WHITE][ROOK] = (1ULL << 0) | (1ULL << 7);
 
     // As torres pretas começam nas casas a8 e h8
     // Correspondem aos índices 56 e 63
     // 10000001 <- Peças
     // ...
     // 00000000
-    black_rooks = (1ULL << 56) | (1ULL << 63);
+    pieces[BLACK][ROOK] = (1ULL << 56) | (1ULL << 63);
 
     // Os bispos brancos começam nas casas c1 e f1
     // Correspondem aos índices 2 e 5
     // 00000000
     // ...
     // 00100100 <- Peças
-    white_bishops = (1ULL << 2) | (1ULL << 5);
+    pieces[WHITE][BISHOP] = (1ULL << 2) | (1ULL << 5);
 
     // Os bispos pretos começam nas casas c8 e f8
     // Correspondem aos índices 58 e 61
     // 00100100 <- Peças
     // ...
     // 00000000
-    black_bishops = (1ULL << 58) | (1ULL << 61);
+    pieces[BLACK][BISHOP] = (1ULL << 58) | (1ULL << 61);
 
     // As rainhas brancas começam na casa d1, correspondente ao índice 3
     // 00000000
     // ...
     // 00001000 <- Peças
-    white_queens = (1ULL << 3);
+    pieces[WHITE][QUEEN] = (1ULL << 3);
 
     // As rainhas pretas começam na casa d8, correspondente ao índice 59
     // 00001000 <- Peças
     // ...
     // 00000000
-    black_queens = (1ULL << 59);
+    pieces[BLACK][QUEEN] = (1ULL << 59);
 
-    // Calculando os bitboards de ocupação
-    white_occupied = white_pawns | white_king | white_knights | white_rooks |
-                     white_bishops | white_queens;
-    black_occupied = black_pawns | black_king | black_knights | black_rooks |
-                     black_bishops | black_queens;
-    all_occupied = white_occupied | black_occupied;
+    // Calculando os bitboards de ocupação e preenchendo o mailbox
+    for (int square = 0; square < 64; ++square) {
+        mailbox[square] = NO_PIECE;
+    }
+    for (int color = WHITE; color <= BLACK; ++color) {
+        occupied[color] = 0ULL;
+        for (int type = PAWN; type <= KING; ++type) {
+            occupied[color] |= pieces[color][type];
+
+            uint64_t remaining = pieces[color][type];
+            while (remaining) {
+                mailbox[__builtin_ctzll(remaining)] =
+                    make_piece(Color(color), PieceType(type));
+                remaining &= remaining - 1;
+            }
+        }
+    }
+    all_occupied = occupied[WHITE] | occupied[BLACK];
 
     // Definir o turno inicial
     turn = WHITE;
+
+    // Todos os roques disponíveis, sem en passant e sem lances sem captura
+    castling_rights = ALL_CASTLING;
+    en_passant_square = NO_SQUARE;
+    halfmove_clock = 0;
+    fullmove_number = 1;
+
+    // Calcula a chave e os termos da avaliação da posição inicial
+    Zobrist::init();
+    key = compute_key();
+    int mg, eg, game_phase;
+    compute_psqt(mg, eg, game_phase);
+    mg_score = int16_t(mg);
+    eg_score = int16_t(eg);
+    phase = uint8_t(game_phase);
+    pawn_key = compute_pawn_key();
 }
 
-// Aplica um movimento no tabuleiro
-void Board::make_move(const Move& move_to_apply) {
-    // Cria uma máscara de bit para a casa de origem e destino
-    const uint64_t from_bit = (1ULL << move_to_apply.from());
-    const uint64_t to_bit = (1ULL << move_to_apply.to());
-
-    // Salva o tipo de peça que está se movendo
-    PieceType moving_piece = NONE;
-    if (turn == WHITE) {
-        if (white_pawns & from_bit) {
-            moving_piece = PAWN;
-        } else if (white_knights & from_bit) {
-            moving_piece = KNIGHT;
-        } else if (white_bishops & from_bit) {
-            moving_piece = BISHOP;
-        } else if (white_rooks & from_bit) {
-            moving_piece = ROOK;
-        } else if (white_queens & from_bit) {
-            moving_piece = QUEEN;
-        } else if (white_king & from_bit) {
-            moving_piece = KING;
-        }
-    } else {
-        if (black_pawns & from_bit) {
-            moving_piece = PAWN;
-        } else if (black_knights & from_bit) {
-            moving_piece = KNIGHT;
-        } else if (black_bishops & from_bit) {
-            moving_piece = BISHOP;
-        } else if (black_rooks & from_bit) {
-            moving_piece = ROOK;
-        } else if (black_queens & from_bit) {
-            moving_piece = QUEEN;
-        } else if (black_king & from_bit) {
-            moving_piece = KING;
+// Calcula a chave Zobrist do zero: XOR das chaves de cada peça em sua casa,
+// da chave do turno quando as pretas jogam, dos direitos de roque e da coluna
+// de en passant
+uint64_t Position::compute_key() const {
+    uint64_t result = 0ULL;
+    for (int color = WHITE; color <= BLACK; ++color) {
+        for (int type = PAWN; type <= KING; ++type) {
+            uint64_t remaining = pieces[color][type];
+            while (remaining) {
+                int square = __builtin_ctzll(remaining);
+                result ^= Zobrist::piece_keys[color][type][square];
+                remaining &= remaining - 1;
+            }
         }
     }
 
-    // Nenhuma peça do jogador atual na casa de origem, não pode mover
-    if (moving_piece == NONE) {
-        std::cerr << "Erro: Movimento inválido. Nenhuma peça do jogador atual "
-                     "na casa de origem."
-                  << std::endl;
-        return;
+    if (turn == BLACK) result ^= Zobrist::side_key;
+
+    result ^= Zobrist::castling_keys[castling_rights];
+    if (en_passant_square != NO_SQUARE) {
+        result ^= Zobrist::en_passant_keys[en_passant_square % 8];
     }
 
-    // Prepara a informação para desfazer o movimento
-    UndoInfo undo;
-    undo.move = move_to_apply;
-    undo.captured_piece = NONE;
+    return result;
+}
 
-    // Pega o bitboard de ocupação do oponente
-    const uint64_t opponent_occupied =
-        (turn == WHITE) ? black_occupied : white_occupied;
-
-    // Se a casa de destino está ocupada por uma peça do oponente,
-    // é uma captura.
-    if (opponent_occupied & to_bit) {
-        // Percorre os bitboards das peças pretas para remover e salvar o tipo
-        // da peça capturada.
-        if (turn == WHITE) {
-            if (black_pawns & to_bit) {
-                undo.captured_piece = PAWN;
-                black_pawns &= ~to_bit;
-            } else if (black_knights & to_bit) {
-                undo.captured_piece = KNIGHT;
-                black_knights &= ~to_bit;
-            } else if (black_bishops & to_bit) {
-                undo.captured_piece = BISHOP;
-                black_bishops &= ~to_bit;
-            } else if (black_rooks & to_bit) {
-                undo.captured_piece = ROOK;
-                black_rooks &= ~to_bit;
-            } else if (black_queens & to_bit) {
-                undo.captured_piece = QUEEN;
-                black_queens &= ~to_bit;
-            }
-            black_occupied &= ~to_bit;  // Atualiza o bitboard de ocupação
+uint64_t Position::compute_pawn_key() const {
+    uint64_t result = 0ULL;
+    for (int color = WHITE; color <= BLACK; ++color) {
+        uint64_t remaining = pieces[color][PAWN];
+        while (remaining) {
+            result ^= Zobrist::piece_keys[color][PAWN]
+                                         [__builtin_ctzll(remaining)];
+            remaining &= remaining - 1;
         }
-        // Percorre os bitboards das peças brancas para remover e salvar o tipo
-        // da peça capturada.
-        else {
-            if (white_pawns & to_bit) {
-                undo.captured_piece = PAWN;
-                white_pawns &= ~to_bit;
-            } else if (white_knights & to_bit) {
-                undo.captured_piece = KNIGHT;
-                white_knights &= ~to_bit;
-            } else if (white_bishops & to_bit) {
-                undo.captured_piece = BISHOP;
-                white_bishops &= ~to_bit;
-            } else if (white_rooks & to_bit) {
-                undo.captured_piece = ROOK;
-                white_rooks &= ~to_bit;
-            } else if (white_queens & to_bit) {
-                undo.captured_piece = QUEEN;
-                white_queens &= ~to_bit;
+    }
+    return result;
+}
+
+// Soma os valores de PSQT::table de cada peça em sua casa, como a avaliação
+// fazia antes de os termos serem mantidos a cada movimento
+void Position::compute_psqt(int& mg, int& eg, int& game_phase) const {
+    mg = eg = game_phase = 0;
+    for (int color = WHITE; color <= BLACK; ++color) {
+        for (int type = PAWN; type <= KING; ++type) {
+            const Piece piece = make_piece(Color(color), PieceType(type));
+            uint64_t remaining = pieces[color][type];
+            while (remaining) {
+                const int square = __builtin_ctzll(remaining);
+                mg += PSQT::table.mg[piece][square];
+                eg += PSQT::table.eg[piece][square];
+                game_phase += PSQT::table.phase[piece];
+                remaining &= remaining - 1;
             }
-            white_occupied &= ~to_bit;  //  Atualiza o bitboard de ocupação
         }
     }
+}
 
-    // Guarda o movimento no histórico
-    history.push_back(undo);
-
-    // Move a peça do jogador atual da casa de origem para a casa de destino e
-    // atualiza o bitboard de ocupação dele.
-    if (turn == WHITE) {
-        switch (moving_piece) {
-            case PAWN:
-                white_pawns ^= (from_bit | to_bit);
-                break;
-            case KNIGHT:
-                white_knights ^= (from_bit | to_bit);
-                break;
-            case BISHOP:
-                white_bishops ^= (from_bit | to_bit);
-                break;
-            case ROOK:
-                white_rooks ^= (from_bit | to_bit);
-                break;
-            case QUEEN:
-                white_queens ^= (from_bit | to_bit);
-                break;
-            case KING:
-                white_king ^= (from_bit | to_bit);
-                break;
-            case NONE:
-                break;
-        }
-        white_occupied ^= (from_bit | to_bit);
+// Colunas das bordas, para achar as casas vizinhas sem dar a volta
+static const uint64_t FILE_A = 0x0101010101010101ULL;
+static const uint64_t FILE_H = 0x8080808080808080ULL;
+
+// Direitos de roque que continuam válidos quando uma peça sai de ou chega em
+// cada casa: mover o rei ou uma torre, ou ter a torre capturada, perde o
+// roque daquele lado
+static const uint8_t castling_masks[64] = {
+    13, 15, 15, 15, 12, 15, 15, 14,  // a1 (OOO branco), e1, h1 (OO branco)
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    7,  15, 15, 15, 3,  15, 15, 11   // a8 (OOO preto), e8, h8 (OO preto)
+};
+
+// Casas de origem e destino da torre em um roque, a partir do movimento do
+// rei (o rei anda duas casas e a torre pula para o outro lado dele)
+static inline void castling_rook_squares(int king_from, int king_to,
+                                         int& rook_from, int& rook_to) {
+    const bool king_side = king_to > king_from;
+    rook_from = king_side ? king_to + 1 : king_to - 2;
+    rook_to = king_side ? king_to - 1 : king_to + 1;
+}
+
+// Casa da peça capturada: no en passant o peão capturado está atrás da casa
+// de destino; nos outros movimentos, na própria casa de destino
+static inline int capture_square_of(const Move& move, Color us) {
+    const int to = move.to();
+    if (move.type() != MoveType::EN_PASSANT) return to;
+    return (us == WHITE) ? to - 8 : to + 8;
+}
+
+// Aplica um movimento na posição, sem guardar informação para desfazer
+void Position::apply_move(const Move& move) {
+    const int from = move.from();
+    const int to = move.to();
+    const int move_type = move.type();
+
+    const Color us = turn;
+    const Color opponent = (us == WHITE) ? BLACK : WHITE;
+    const PieceType moving_type = type_of(mailbox[from]);
+
+    // A casa de en passant só vale para o lance seguinte ao avanço duplo
+    if (en_passant_square != NO_SQUARE) {
+        key ^= Zobrist::en_passant_keys[en_passant_square % 8];
+        en_passant_square = NO_SQUARE;
+    }
+
+    ++halfmove_clock;
+
+    if (move_type == MoveType::CASTLING) {
+        // Roque: move o rei e a torre, nunca há captura
+        int rook_from, rook_to;
+        castling_rook_squares(from, to, rook_from, rook_to);
+
+        move_piece(from, to);
+        move_piece(rook_from, rook_to);
+
+        key ^= Zobrist::piece_keys[us][KING][from] ^
+               Zobrist::piece_keys[us][KING][to] ^
+               Zobrist::piece_keys[us][ROOK][rook_from] ^
+               Zobrist::piece_keys[us][ROOK][rook_to];
     } else {
-        switch (moving_piece) {
-            case PAWN:
-                black_pawns ^= (from_bit | to_bit);
-                break;
-            case KNIGHT:
-                black_knights ^= (from_bit | to_bit);
-                break;
-            case BISHOP:
-                black_bishops ^= (from_bit | to_bit);
-                break;
-            case ROOK:
-                black_rooks ^= (from_bit | to_bit);
-                break;
-            case QUEEN:
-                black_queens ^= (from_bit | to_bit);
-                break;
-            case KING:
-                black_king ^= (from_bit | to_bit);
-                break;
-            case NONE:
-                break;
+        // Se há uma peça do oponente, remove ela dos bitboards e da chave
+        const int capture_square = capture_square_of(move, us);
+        const Piece captured_piece = mailbox[capture_square];
+        if (captured_piece != NO_PIECE) {
+            remove_piece(capture_square);
+            key ^= Zobrist::piece_keys[opponent][type_of(captured_piece)]
+                                      [capture_square];
+            halfmove_clock = 0;
+        }
+
+        // Move a peça do jogador atual da casa de origem para a de destino
+        move_piece(from, to);
+        key ^= Zobrist::piece_keys[us][moving_type][from] ^
+               Zobrist::piece_keys[us][moving_type][to];
+
+        if (moving_type == PAWN) {
+            halfmove_clock = 0;
+
+            if (move_type == MoveType::PROMOTION) {
+                // Troca o peão que chegou na última fileira pela peça
+                // escolhida
+                const PieceType promoted =
+                    PieceType(KNIGHT + move.promotion_piece_type());
+                remove_piece(to);
+                put_piece(make_piece(us, promoted), to);
+                key ^= Zobrist::piece_keys[us][PAWN][to] ^
+                       Zobrist::piece_keys[us][promoted][to];
+            } else if ((from ^ to) == 16) {
+                // Avanço duplo: marca a casa pulada se algum peão do
+                // oponente está ao lado do destino e pode capturar
+                const uint64_t to_bit = 1ULL << to;
+                const uint64_t neighbours =
+                    ((to_bit << 1) & ~FILE_A) | ((to_bit >> 1) & ~FILE_H);
+                if (neighbours & pieces[opponent][PAWN]) {
+                    en_passant_square = uint8_t((from + to) / 2);
+                    key ^= Zobrist::en_passant_keys[en_passant_square % 8];
+                }
+            }
         }
-        black_occupied ^= (from_bit | to_bit);
     }
 
-    // Atualiza o bitboard de ocupação total
-    all_occupied = white_occupied | black_occupied;
+    // Mover o rei ou uma torre, ou capturar uma torre, perde direitos de roque
+    const uint8_t new_rights =
+        castling_rights & castling_masks[from] & castling_masks[to];
+    if (new_rights != castling_rights) {
+        key ^= Zobrist::castling_keys[castling_rights] ^
+               Zobrist::castling_keys[new_rights];
+        castling_rights = new_rights;
+    }
 
     // Alterna o turno
-    turn = (turn == WHITE) ? BLACK : WHITE;
+    key ^= Zobrist::side_key;
+    turn = opponent;
+    if (us == BLACK) ++fullmove_number;
+
+#ifdef DEBUG_HASH
+    verify_key("apply_move");
+#endif
+}
+
+// Aplica um movimento no tabuleiro, guardando o necessário para desfazê-lo
+bool Board::make_move(const Move& move_to_apply) {
+    // Sem espaço no histórico o movimento não poderia ser desfeito
+    if (history_size == int(history.size())) return false;
+
+    const Piece moving_piece = mailbox[move_to_apply.from()];
+
+    // Nenhuma peça do jogador atual na casa de origem, não pode mover
+    if (moving_piece == NO_PIECE || color_of(moving_piece) != turn) {
+        return false;
+    }
+
+    // Prepara a informação para desfazer o movimento com o estado que o
+    // movimento vai perder
+    UndoInfo undo;
+    undo.move = move_to_apply;
+    undo.halfmove_clock = halfmove_clock;
+    undo.castling_rights = castling_rights;
+    undo.en_passant_square = en_passant_square;
+
+    const Piece captured_piece =
+        (move_to_apply.type() == MoveType::CASTLING)
+            ? NO_PIECE
+            : mailbox[capture_square_of(move_to_apply, turn)];
+    undo.captured_piece =
+        (captured_piece == NO_PIECE) ? NONE : type_of(captured_piece);
+
+    // Guarda o movimento e a chave atual no histórico
+    history[history_size] = undo;
+    key_history[history_size] = key;
+    ++history_size;
+
+    apply_move(move_to_apply);
+    return true;
 }
 
 // Desfaz o último movimento aplicado no tabuleiro
 void Board::undo_move() {
     // Se não houver histórico, não há nada para desfazer
-    if (history.empty()) {
+    if (history_size == 0) {
         return;
     }
 
     // Salvo o último movimento e o remove do histórico
-    UndoInfo last_undo = history.back();
-    history.pop_back();
+    --history_size;
+    const UndoInfo last_undo = history[history_size];
+
+    // A chave anterior foi salva na pilha de chaves
+    key = key_history[history_size];
 
-    // Cria uma máscara de bit para a casa de origem e destino do movimento
-    // que estamos desfazendo
-    const uint64_t from_bit = (1ULL << last_undo.move.from());
-    const uint64_t to_bit = (1ULL << last_undo.move.to());
+    const int from = last_undo.move.from();
+    const int to = last_undo.move.to();
+    const int move_type = last_undo.move.type();
 
     // Troca o turno de volta para o jogador que fez o movimento
+    const Color opponent = turn;
+    const Color us = (turn == WHITE) ? BLACK : WHITE;
+    turn = us;
+
+    if (move_type == MoveType::CASTLING) {
+        // Devolve o rei e a torre para as casas de origem
+        int rook_from, rook_to;
+        castling_rook_squares(from, to, rook_from, rook_to);
+
+        move_piece(to, from);
+        move_piece(rook_to, rook_from);
+    } else {
+        // A peça promovida volta a ser um peão antes de voltar para a origem
+        if (move_type == MoveType::PROMOTION) {
+            remove_piece(to);
+            put_piece(make_piece(us, PAWN), to);
+        }
+
+        move_piece(to, from);
+
+        // Restaura a peça capturada, se houver
+        if (last_undo.captured_piece != NONE) {
+            put_piece(
+                make_piece(opponent, PieceType(last_undo.captured_piece)),
+                capture_square_of(last_undo.move, us));
+        }
+    }
+
+    // Restaura o estado que o movimento não tem como recalcular
+    if (us == BLACK) --fullmove_number;
+    castling_rights = last_undo.castling_rights;
+    en_passant_square = last_undo.en_passant_square;
+    halfmove_clock = last_undo.halfmove_clock;
+
+#ifdef DEBUG_HASH
+    verify_key("undo_move");
+#endif
+}
+
+bool Board::make_null_move() {
+    if (history_size == int(history.size())) return false;
+
+    UndoInfo undo;
+    undo.move = Move();
+    undo.halfmove_clock = halfmove_clock;
+    undo.captured_piece = NONE;
+    undo.castling_rights = castling_rights;
+    undo.en_passant_square = en_passant_square;
+
+    history[history_size] = undo;
+    key_history[history_size] = key;
+    ++history_size;
+
+    if (en_passant_square != NO_SQUARE) {
+        key ^= Zobrist::en_passant_keys[en_passant_square % 8];
+        en_passant_square = NO_SQUARE;
+    }
+    halfmove_clock = 0;
     turn = (turn == WHITE) ? BLACK : WHITE;
+    key ^= Zobrist::side_key;
+
+#ifdef DEBUG_HASH
+    verify_key("make_null_move");
+#endif
+    return true;
+}
+
+void Board::undo_null_move() {
+    if (history_size == 0) return;
+
+    --history_size;
+    const UndoInfo& last_undo = history[history_size];
+
+    key = key_history[history_size];
+    turn = (turn == WHITE) ? BLACK : WHITE;
+    en_passant_square = last_undo.en_passant_square;
+    halfmove_clock = last_undo.halfmove_clock;
+
+#ifdef DEBUG_HASH
+    verify_key("undo_null_move");
+#endif
+}
+
+// Retorna o próximo campo da FEN (separados por espaços), avançando pos
+static std::string_view next_field(std::string_view fen, size_t& pos) {
+    while (pos < fen.size() && fen[pos] == ' ') ++pos;
+    const size_t start = pos;
+    while (pos < fen.size() && fen[pos] != ' ') ++pos;
+    return fen.substr(start, pos - start);
+}
+
+// Material que pode existir em uma partida: no máximo 16 peças e 8 peões, e
+// cada peça além das iniciais (uma dama, duas torres, dois bispos e dois
+// cavalos) veio da promoção de um peão que falta. Sem isso a lista de
+// movimentos (MoveList, 256) poderia estourar e mg_score/eg_score
+// (int16_t) sair do intervalo.
+static bool material_is_possible(const Position& pos, Color color) {
+    const auto count = [&pos, color](PieceType type) {
+        return __builtin_popcountll(pos.pieces[color][type]);
+    };
+    const int promoted = std::max(0, count(QUEEN) - 1) +
+                         std::max(0, count(ROOK) - 2) +
+                         std::max(0, count(BISHOP) - 2) +
+                         std::max(0, count(KNIGHT) - 2);
+    return __builtin_popcountll(pos.occupied[color]) <= 16 &&
+           count(PAWN) <= 8 && promoted <= 8 - count(PAWN);
+}
+
+// Lê um número decimal não negativo de até max. Retorna false se o campo não
+// for um número ou passar do limite.
+static bool parse_number(std::string_view field, int max, int& value) {
+    if (field.empty()) return false;
+    value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+        if (value > max) return false;
+    }
+    return true;
+}
+
+// Escreve um número decimal não negativo e avança o ponteiro
+static void write_number(char*& out, unsigned value) {
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count) *out++ = digits[--count];
+}
 
-    // Salva o tipo da peça que foi movida. (peça está na casa de destino)
-    PieceType moved_piece = NONE;
-    if (turn == WHITE) {
-        if (white_pawns & to_bit) {
-            moved_piece = PAWN;
-        } else if (white_knights & to_bit) {
-            moved_piece = KNIGHT;
-        } else if (white_bishops & to_bit) {
-            moved_piece = BISHOP;
-        } else if (white_rooks & to_bit) {
-            moved_piece = ROOK;
-        } else if (white_queens & to_bit) {
-            moved_piece = QUEEN;
-        } else if (white_king & to_bit) {
-            moved_piece = KING;
+// Letra de cada roque na FEN, com as casas onde o rei e a torre precisam
+// estar para que o direito faça sentido
+struct CastlingFen {
+    char symbol;
+    uint8_t right;
+    Piece king;
+    int king_square;
+    Piece rook;
+    int rook_square;
+};
+
+static const CastlingFen CASTLING_FEN[4] = {
+    {'K', WHITE_OO, W_KING, 4, W_ROOK, 7},
+    {'Q', WHITE_OOO, W_KING, 4, W_ROOK, 0},
+    {'k', BLACK_OO, B_KING, 60, B_ROOK, 63},
+    {'q', BLACK_OOO, B_KING, 60, B_ROOK, 56},
+};
+
+bool Position::from_fen(std::string_view fen) {
+    Zobrist::init();
+    MoveGen::init_tables();
+
+    // A posição é montada em uma cópia local e só substitui a atual se a
+    // FEN inteira for válida
+    Position pos;
+    for (int color = WHITE; color <= BLACK; ++color) {
+        pos.occupied[color] = 0ULL;
+        for (int type = PAWN; type <= KING; ++type) {
+            pos.pieces[color][type] = 0ULL;
+        }
+    }
+    pos.all_occupied = 0ULL;
+    for (int square = 0; square < 64; ++square) {
+        pos.mailbox[square] = NO_PIECE;
+    }
+    pos.mg_score = 0;
+    pos.eg_score = 0;
+    pos.phase = 0;
+    pos.pawn_key = 0ULL;
+
+    size_t cursor = 0;
+
+    /**
+     * 1. Peças, da oitava fileira para a primeira e da coluna 'a' para a 'h'
+     */
+    const std::string_view placement = next_field(fen, cursor);
+    int rank = 7;
+    int file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) return false;
+            --rank;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return false;
+        } else {
+            int piece = 0;
+            while (piece < 12 && PIECE_CHARS[piece] != c) ++piece;
+            if (piece == 12 || file > 7) return false;
+            pos.put_piece(Piece(piece), rank * 8 + file);
+            ++file;
         }
+    }
+    if (rank != 0 || file != 8) return false;
+
+    // Um rei de cada cor e nenhum peão na primeira ou na última fileira
+    const uint64_t BACK_RANKS = 0xFF000000000000FFULL;
+    if (__builtin_popcountll(pos.pieces[WHITE][KING]) != 1 ||
+        __builtin_popcountll(pos.pieces[BLACK][KING]) != 1 ||
+        ((pos.pieces[WHITE][PAWN] | pos.pieces[BLACK][PAWN]) & BACK_RANKS)) {
+        return false;
+    }
+    if (!material_is_possible(pos, WHITE) ||
+        !material_is_possible(pos, BLACK)) {
+        return false;
+    }
+
+    /**
+     * 2. Lado a jogar
+     */
+    const std::string_view side = next_field(fen, cursor);
+    if (side == "w") {
+        pos.turn = WHITE;
+    } else if (side == "b") {
+        pos.turn = BLACK;
     } else {
-        if (black_pawns & to_bit) {
-            moved_piece = PAWN;
-        } else if (black_knights & to_bit) {
-            moved_piece = KNIGHT;
-        } else if (black_bishops & to_bit) {
-            moved_piece = BISHOP;
-        } else if (black_rooks & to_bit) {
-            moved_piece = ROOK;
-        } else if (black_queens & to_bit) {
-            moved_piece = QUEEN;
-        } else if (black_king & to_bit) {
-            moved_piece = KING;
+        return false;
+    }
+
+    /**
+     * 3. Roques: cada direito exige o rei e a torre nas casas iniciais
+     */
+    const std::string_view castling = next_field(fen, cursor);
+    pos.castling_rights = NO_CASTLING;
+    if (castling.empty()) return false;
+    if (castling != "-") {
+        for (char c : castling) {
+            int i = 0;
+            while (i < 4 && CASTLING_FEN[i].symbol != c) ++i;
+            if (i == 4) return false;
+
+            // Cada letra aparece uma vez só
+            const CastlingFen& entry = CASTLING_FEN[i];
+            if (pos.castling_rights & entry.right) return false;
+            if (pos.mailbox[entry.king_square] != entry.king ||
+                pos.mailbox[entry.rook_square] != entry.rook) {
+                return false;
+            }
+            pos.castling_rights |= entry.right;
         }
     }
 
-    // Move a peça de volta para a casa de origem e atualiza os bitboards
-    if (turn == WHITE) {
-        switch (moved_piece) {
-            case PAWN:
-                white_pawns ^= (from_bit | to_bit);
-                break;
-            case KNIGHT:
-                white_knights ^= (from_bit | to_bit);
-                break;
-            case BISHOP:
-                white_bishops ^= (from_bit | to_bit);
-                break;
-            case ROOK:
-                white_rooks ^= (from_bit | to_bit);
-                break;
-            case QUEEN:
-                white_queens ^= (from_bit | to_bit);
-                break;
-            case KING:
-                white_king ^= (from_bit | to_bit);
-                break;
-            case NONE:
-                break;
+    /**
+     * 4. En passant: a casa pulada pelo último avanço duplo do oponente
+     */
+    const std::string_view en_passant = next_field(fen, cursor);
+    pos.en_passant_square = NO_SQUARE;
+    if (en_passant.empty()) return false;
+    if (en_passant != "-") {
+        if (en_passant.size() != 2 || en_passant[0] < 'a' ||
+            en_passant[0] > 'h') {
+            return false;
         }
-        white_occupied ^= (from_bit | to_bit);
-    } else {
-        switch (moved_piece) {
-            case PAWN:
-                black_pawns ^= (from_bit | to_bit);
-                break;
-            case KNIGHT:
-                black_knights ^= (from_bit | to_bit);
-                break;
-            case BISHOP:
-                black_bishops ^= (from_bit | to_bit);
-                break;
-            case ROOK:
-                black_rooks ^= (from_bit | to_bit);
-                break;
-            case QUEEN:
-                black_queens ^= (from_bit | to_bit);
-                break;
-            case KING:
-                black_king ^= (from_bit | to_bit);
-                break;
-            case NONE:
-                break;
+        const Color us = pos.turn;
+        const Color them = (us == WHITE) ? BLACK : WHITE;
+        const int ep_file = en_passant[0] - 'a';
+        const int ep_rank = (us == WHITE) ? 5 : 2;
+        if (en_passant[1] != char('1' + ep_rank)) return false;
+
+        // O peão que avançou está à frente da casa e as casas que ele
+        // atravessou estão vazias
+        const int square = ep_rank * 8 + ep_file;
+        const int pawn_square = (us == WHITE) ? square - 8 : square + 8;
+        const int start_square = (us == WHITE) ? square + 8 : square - 8;
+        if (pos.mailbox[pawn_square] != make_piece(them, PAWN) ||
+            pos.mailbox[square] != NO_PIECE ||
+            pos.mailbox[start_square] != NO_PIECE) {
+            return false;
         }
-        black_occupied ^= (from_bit | to_bit);
-    }
-
-    // Restaura a peça capturada, se houver
-    if (last_undo.captured_piece != NONE) {
-        const Color opponent_color = (turn == WHITE) ? BLACK : WHITE;
-        if (opponent_color == WHITE) {
-            switch (last_undo.captured_piece) {
-                case PAWN:
-                    white_pawns |= to_bit;
-                    break;
-                case KNIGHT:
-                    white_knights |= to_bit;
-                    break;
-                case BISHOP:
-                    white_bishops |= to_bit;
-                    break;
-                case ROOK:
-                    white_rooks |= to_bit;
-                    break;
-                case QUEEN:
-                    white_queens |= to_bit;
-                    break;
-                case KING:
-                    white_king |= to_bit;
-                    break;
-                case NONE:
-                    break;
-            }
-            white_occupied |= to_bit;
-        } else {
-            switch (last_undo.captured_piece) {
-                case PAWN:
-                    black_pawns |= to_bit;
-                    break;
-                case KNIGHT:
-                    black_knights |= to_bit;
-                    break;
-                case BISHOP:
-                    black_bishops |= to_bit;
-                    break;
-                case ROOK:
-                    black_rooks |= to_bit;
-                    break;
-                case QUEEN:
-                    black_queens |= to_bit;
-                    break;
-                case KING:
-                    black_king |= to_bit;
-                    break;
-                case NONE:
-                    break;
+
+        // Como em apply_move, a casa só é marcada se algum peão pode
+        // capturar, para que a chave não dependa de como a FEN foi escrita
+        const uint64_t pawn_bit = 1ULL << pawn_square;
+        const uint64_t neighbours = ((pawn_bit << 1) & ~FILE_A) |
+                                    ((pawn_bit >> 1) & ~FILE_H);
+        if (neighbours & pos.pieces[us][PAWN]) {
+            pos.en_passant_square = uint8_t(square);
+        }
+    }
+
+    /**
+     * 5. Contadores de lances (opcionais, como em EPD, mas os dois juntos)
+     */
+    int halfmove = 0;
+    int fullmove = 1;
+    const std::string_view halfmove_field = next_field(fen, cursor);
+    const std::string_view fullmove_field = next_field(fen, cursor);
+    if (!halfmove_field.empty() &&
+        (!parse_number(halfmove_field, 65535, halfmove) ||
+         !parse_number(fullmove_field, 65535, fullmove))) {
+        return false;
+    }
+
+    // Nada pode sobrar depois do último campo
+    if (!next_field(fen, cursor).empty()) return false;
+    pos.halfmove_clock = uint16_t(halfmove);
+    pos.fullmove_number = uint16_t(std::max(fullmove, 1));
+
+    // O lado que acabou de jogar não pode ter deixado o rei em xeque
+    const Color them = (pos.turn == WHITE) ? BLACK : WHITE;
+    if (MoveGen::is_square_attacked(__builtin_ctzll(pos.pieces[them][KING]),
+                                    pos.turn, pos)) {
+        return false;
+    }
+
+    pos.key = pos.compute_key();
+    *this = pos;
+    return true;
+}
+
+int Position::to_fen(char* buffer) const {
+    char* out = buffer;
+
+    // Peças, com as casas vazias consecutivas contadas
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+        for (int file = 0; file < 8; ++file) {
+            const Piece piece = mailbox[rank * 8 + file];
+            if (piece == NO_PIECE) {
+                ++empty;
+                continue;
             }
-            black_occupied |= to_bit;
+            if (empty) *out++ = char('0' + empty);
+            empty = 0;
+            *out++ = PIECE_CHARS[piece];
         }
+        if (empty) *out++ = char('0' + empty);
+        if (rank > 0) *out++ = '/';
+    }
+
+    *out++ = ' ';
+    *out++ = (turn == WHITE) ? 'w' : 'b';
+
+    *out++ = ' ';
+    if (castling_rights == NO_CASTLING) *out++ = '-';
+    if (castling_rights & WHITE_OO) *out++ = 'K';
+    if (castling_rights & WHITE_OOO) *out++ = 'Q';
+    if (castling_rights & BLACK_OO) *out++ = 'k';
+    if (castling_rights & BLACK_OOO) *out++ = 'q';
+
+    *out++ = ' ';
+    if (en_passant_square == NO_SQUARE) {
+        *out++ = '-';
+    } else {
+        *out++ = char('a' + en_passant_square % 8);
+        *out++ = char('1' + en_passant_square / 8);
     }
 
-    // Atualiza o bitboard de ocupação total
-    all_occupied = white_occupied | black_occupied;
+    *out++ = ' ';
+    write_number(out, halfmove_clock);
+    *out++ = ' ';
+    write_number(out, fullmove_number);
+
+    *out = '\0';
+    return int(out - buffer);
 }
 
-// Função temporária para imprimir o tabuleiro no console
-// Futuramente irei usar FEN para representar o estado do tabuleiro
+bool Board::from_fen(std::string_view fen) {
+    if (!Position::from_fen(fen)) return false;
+    history_size = 0;
+    return true;
+}
+
+// Só posições com o mesmo jogador a mover podem se repetir, e nenhuma
+// posição antes da última captura ou movimento de peão, então a busca olha
+// uma chave a cada duas e para no relógio dos 50 lances
+bool Board::is_repetition() const {
+    const int limit = std::min<int>(halfmove_clock, history_size);
+    for (int back = 4; back <= limit; back += 2) {
+        if (key_history[history_size - back] == key) return true;
+    }
+    return false;
+}
+
+#ifdef DEBUG_HASH
+// Confere a chave incremental com o cálculo completo. Só é compilada com
+// -DDEBUG_HASH, pois recalcular a chave a cada movimento é caro.
+void Position::verify_key(const char* where) const {
+    const uint64_t expected = compute_key();
+    if (key != expected) {
+        std::cerr << "Erro: chave Zobrist incorreta após " << where
+                  << " (incremental " << std::hex << key << ", esperada "
+                  << expected << std::dec << ")" << std::endl;
+    }
+
+    if (pawn_key != compute_pawn_key()) {
+        std::cerr << "Erro: chave dos peões incorreta após " << where
+                  << std::endl;
+    }
+
+    // Os termos da PSQT são mantidos pelas mesmas funções que a chave
+    int mg, eg, game_phase;
+    compute_psqt(mg, eg, game_phase);
+    if (mg_score != mg || eg_score != eg || phase != game_phase) {
+        std::cerr << "Erro: PSQT incorreta após " << where << " (incremental "
+                  << mg_score << "/" << eg_score << "/" << int(phase)
+                  << ", esperada " << mg << "/" << eg << "/" << game_phase
+                  << ")" << std::endl;
+    }
+}
+#endif
+
+// Função temporária para imprimir o tabuleiro no console, seguido da FEN
 void Board::print_board(const std::vector<int>& highlighted_squares) const {
     const std::string HIGHLIGHT_BG = "\033[42m";
     const std::string RESET_COLOR = "\033[0m";
@@ -438,34 +795,8 @@ void Board::print_board(const std::vector<int>& highlighted_squares) const {
         std::cout << (rank + 1) << " | ";
         for (int file = 0; file < 8; ++file) {
             int square_index = rank * 8 + file;
-            uint64_t square_bit = (1ULL << square_index);
-            char piece_char = '.';
-
-            if (white_pawns & square_bit) {
-                piece_char = 'P';
-            } else if (black_pawns & square_bit) {
-                piece_char = 'p';
-            } else if (white_king & square_bit) {
-                piece_char = 'K';
-            } else if (black_king & square_bit) {
-                piece_char = 'k';
-            } else if (white_knights & square_bit) {
-                piece_char = 'N';
-            } else if (black_knights & square_bit) {
-                piece_char = 'n';
-            } else if (white_rooks & square_bit) {
-                piece_char = 'R';
-            } else if (black_rooks & square_bit) {
-                piece_char = 'r';
-            } else if (white_bishops & square_bit) {
-                piece_char = 'B';
-            } else if (black_bishops & square_bit) {
-                piece_char = 'b';
-            } else if (white_queens & square_bit) {
-                piece_char = 'Q';
-            } else if (black_queens & square_bit) {
-                piece_char = 'q';
-            }
+            const Piece piece = mailbox[square_index];
+            char piece_char = (piece == NO_PIECE) ? '.' : PIECE_CHARS[piece];
 
             bool is_highlighted =
                 !highlighted_squares.empty() &&
@@ -488,16 +819,21 @@ void Board::print_board(const std::vector<int>& highlighted_squares) const {
 
     std::cout << "Turno: " << (turn == WHITE ? "BRANCAS" : "PRETAS")
               << std::endl;
+
+    char fen[MAX_FEN_LENGTH];
+    to_fen(fen);
+    std::cout << "FEN: " << fen << std::endl;
     std::cout << std::endl;
 }
 
 // Função temporária para imprimir o histórico de movimentos
 void Board::print_history() const {
     std::cout << "Histórico de movimentos:" << std::endl;
-    for (const auto& undo_info : history) {
+    for (int i = 0; i < history_size; ++i) {
+        const UndoInfo& undo_info = history[i];
         std::cout << "Movimento: " << undo_info.move.from() << " -> "
                   << undo_info.move.to()
-                  << ", Peça capturada: " << undo_info.captured_piece
+                  << ", Peça capturada: " << int(undo_info.captured_piece)
                   << std::endl;
     }
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "eval.h"
+
+namespace Eval {
+
+// Bônus do peão passado com a casa da frente vazia, pela fileira contada a
+// partir do lado dele, somado ao bônus de passado da tabela de peões
+const int FREE_PASSER_MG[8] = {0, 0, 0, 5, 10, 15, 25, 0};
+const int FREE_PASSER_EG[8] = {0, 5, 5, 10, 20, 35, 55, 0};
+
+// Cavalo em posto avançado: da quarta à sexta fileira (do lado dele),
+// protegido por um peão próprio e fora do alcance dos peões do oponente
+const int OUTPOST_MG = 20;
+const int OUTPOST_EG = 10;
+
+// Termos das peças que dependem da estrutura de peões guardada na entrada,
+// do ponto de vista de Us
+template <Color Us>
+static void add_piece_terms(const Position& board,
+                            const Pawns::Entry& entry, int& mg, int& eg) {
+    constexpr Color Them = (Us == WHITE) ? BLACK : WHITE;
+    constexpr uint64_t OUTPOST_RANKS =
+        (Us == WHITE) ? 0x0000FFFFFF000000ULL : 0x000000FFFFFF0000ULL;
+
+    // Passados cuja casa da frente está vazia
+    const uint64_t empty = ~board.all_occupied;
+    uint64_t free = entry.passed[Us] &
+                    ((Us == WHITE) ? empty >> 8 : empty << 8);
+    while (free) {
+        const int square = __builtin_ctzll(free);
+        free &= free - 1;
+
+        const int relative_rank = (Us == WHITE) ? square / 8 : 7 - square / 8;
+        mg += FREE_PASSER_MG[relative_rank];
+        eg += FREE_PASSER_EG[relative_rank];
+    }
+
+    const uint64_t outposts =
+        OUTPOST_RANKS & ~entry.attack_spans[Them] &
+        Pawns::pawn_attacks<Us>(board.pieces[Us][PAWN]);
+    const int knights =
+        __builtin_popcountll(board.pieces[Us][KNIGHT] & outposts);
+    mg += knights * OUTPOST_MG;
+    eg += knights * OUTPOST_EG;
+}
+
+void add_pawn_terms(const Position& board, Pawns::Entry& entry, int& mg,
+                    int& eg) {
+    int white_mg = 0, white_eg = 0, black_mg = 0, black_eg = 0;
+    add_piece_terms<WHITE>(board, entry, white_mg, white_eg);
+    add_piece_terms<BLACK>(board, entry, black_mg, black_eg);
+
+    mg += entry.mg + entry.king_shield(WHITE, board) -
+          entry.king_shield(BLACK, board) + white_mg - black_mg;
+    eg += entry.eg + white_eg - black_eg;
+}
+
+// Material e PSQT, já somados na posição, mais os termos que dependem dos
+// peões, guardados na tabela de peões. Os termos de meio-jogo e final são
+// interpolados pela fase.
+int evaluate(const Position& board, Pawns::Table& pawns) {
+    int mg = board.mg_score;
+    int eg = board.eg_score;
+    add_pawn_terms(board, pawns.probe(board), mg, eg);
+    return tapered(mg, eg, board.phase, board.turn);
+}
+
+}  // namespace Eval
@@ -1,41 +1,207 @@
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "bench.h"
 #include "board.h"
 #include "move.h"
 #include "movegen.h"
+#include "perft.h"
+#include "search.h"
+#include "utils.h"
 
-std::string square_to_algebraic(int square_index) {
-    if (square_index < 0 || square_index > 63) {
-        return "??";
+// Lê uma opção da busca que tem valor: -nodes N, -no <técnica> (desliga
+// null, lmr, rfp, futility ou razoring), -lmr-base X e -lmr-div X. Retorna
+// false se a opção não for uma destas.
+static bool parse_search_option(const std::string& option, const char* value,
+                                Search::Limits& limits) {
+    Search::Selectivity& selectivity = limits.selectivity;
+
+    if (option == "-nodes") {
+        limits.nodes = std::strtoull(value, nullptr, 10);
+    } else if (option == "-lmr-base") {
+        selectivity.lmr_base = std::atof(value);
+    } else if (option == "-lmr-div") {
+        if (std::atof(value) > 0) selectivity.lmr_divisor = std::atof(value);
+    } else if (option == "-no") {
+        const std::string name = value;
+        if (name == "null") {
+            selectivity.null_move = false;
+        } else if (name == "lmr") {
+            selectivity.lmr = false;
+        } else if (name == "rfp") {
+            selectivity.reverse_futility = false;
+        } else if (name == "futility") {
+            selectivity.futility = false;
+        } else if (name == "razoring") {
+            selectivity.razoring = false;
+        } else {
+            std::cerr << "Técnica desconhecida: " << name << std::endl;
+        }
+    } else {
+        return false;
     }
-    char file_char = 'a' + (square_index % 8);
-    char rank_char = '1' + (square_index / 8);
-    std::string algebraic_notation = "";
-    algebraic_notation += file_char;
-    algebraic_notation += rank_char;
-    return algebraic_notation;
+    return true;
 }
 
-int algebraic_to_square(const std::string& square_notation) {
-    if (square_notation.length() != 2) {
-        return -1;
+// Limites com a profundidade dada e as opções da busca a partir de first
+static Search::Limits parse_limits(int depth, int first, int argc,
+                                   char* argv[]) {
+    Search::Limits limits;
+    limits.depth = depth;
+    for (int i = first; i + 1 < argc; ++i) {
+        parse_search_option(argv[i], argv[i + 1], limits);
     }
-    char file_char = square_notation[0];
-    char rank_char = square_notation[1];
+    return limits;
+}
+
+int main(int argc, char* argv[]) {
+    // Comandos de linha de comando:
+    // ./main bench            benchmark das consultas de ataques
+    // ./main bench make [prof] [prof da busca]  make/undo contra copy-make
+    //                                          no perft e na busca
+    // ./main bench fen [arquivo]  leitura e escrita de FEN (uma por linha)
+    // ./main bench eval       avaliação incremental contra do zero
+    // ./main perft <prof> [-t N] [-hash MB] [-fen "FEN"]
+    //                         conta os nós até a profundidade
+    // ./main divide <prof> [-t N] [-hash MB] [-fen "FEN"]
+    //                         perft com a contagem de cada movimento da raiz
+    // ./main suite            bateria de posições de referência
+    // ./main search <prof> [-t N] [-time ms] [-hash MB] [-hugepages]
+    //              [-fen "FEN"] [opções da busca]
+    //                         procura o melhor movimento
+    // ./main selfplay [partidas] [nós] [opções de B]
+    //                         partidas entre a busca padrão (A) e B
+    // ./main bench search [prof] [opções]  busca em posições fixas
+    // ./main bench smp [prof]     escala da busca de 1 a todos os núcleos
+    // ./main bench captures [prof]  gen_captures contra todos + filtro
+    // ./main bench evasions   picker de evasões contra capturas + quietos
+    // ./main bench tactics [prof] [opções]  posições táticas
+    // Opções da busca: -nodes N, -no null|lmr|rfp|futility|razoring,
+    // -lmr-base X, -lmr-div X
+    if (argc > 1) {
+        std::string command = argv[1];
+
+        if (command == "bench") {
+            if (argc > 2 && std::string(argv[2]) == "make") {
+                Bench::make_modes((argc > 3) ? std::atoi(argv[3]) : 6,
+                                  (argc > 4) ? std::atoi(argv[4]) : 5);
+            } else if (argc > 2 && std::string(argv[2]) == "search") {
+                Bench::search(parse_limits(
+                    (argc > 3) ? std::atoi(argv[3]) : 6, 4, argc, argv));
+            } else if (argc > 2 && std::string(argv[2]) == "tactics") {
+                Bench::tactics(parse_limits(
+                    (argc > 3) ? std::atoi(argv[3]) : 6, 4, argc, argv));
+            } else if (argc > 2 && std::string(argv[2]) == "captures") {
+                Bench::captures((argc > 3) ? std::atoi(argv[3]) : 8);
+            } else if (argc > 2 && std::string(argv[2]) == "evasions") {
+                Bench::evasions();
+            } else if (argc > 2 && std::string(argv[2]) == "smp") {
+                Bench::smp((argc > 3) ? std::atoi(argv[3]) : 7);
+            } else if (argc > 2 && std::string(argv[2]) == "eval") {
+                Bench::eval();
+            } else if (argc > 2 && std::string(argv[2]) == "fen") {
+                Bench::fen((argc > 3) ? argv[3] : nullptr);
+            } else {
+                Bench::attacks();
+            }
+            return 0;
+        }
+
+        if (command == "perft" || command == "divide") {
+            int depth = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+            // Por padrão usa todos os núcleos disponíveis
+            int threads = int(std::thread::hardware_concurrency());
+            int hash_megabytes = 0;
+            const char* fen = START_FEN;
+            for (int i = 3; i + 1 < argc; ++i) {
+                if (std::string(argv[i]) == "-t") {
+                    threads = std::atoi(argv[i + 1]);
+                } else if (std::string(argv[i]) == "-hash") {
+                    hash_megabytes = std::atoi(argv[i + 1]);
+                } else if (std::string(argv[i]) == "-fen") {
+                    fen = argv[i + 1];
+                }
+            }
+            if (threads < 1) threads = 1;
+            if (hash_megabytes < 0) hash_megabytes = 0;
+
+            Board board;
+            if (!board.from_fen(fen)) {
+                std::cerr << "FEN inválida: " << fen << std::endl;
+                return 1;
+            }
+            Perft::run(board, depth, command == "divide", threads,
+                       size_t(hash_megabytes));
+            return 0;
+        }
+
+        if (command == "search") {
+            Search::Limits limits;
+            limits.depth = (argc > 2) ? std::atoi(argv[2]) : 7;
+            const char* fen = START_FEN;
+            int hash_megabytes = 16;
+            bool huge_pages = false;
+            for (int i = 3; i < argc; ++i) {
+                const std::string option = argv[i];
+                if (option == "-hugepages") {
+                    huge_pages = true;
+                } else if (i + 1 == argc) {
+                    break;
+                } else if (option == "-t") {
+                    limits.threads = std::atoi(argv[i + 1]);
+                } else if (option == "-time") {
+                    limits.movetime_ms = std::atoll(argv[i + 1]);
+                } else if (option == "-hash") {
+                    hash_megabytes = std::atoi(argv[i + 1]);
+                } else if (option == "-fen") {
+                    fen = argv[i + 1];
+                } else {
+                    parse_search_option(option, argv[i + 1], limits);
+                }
+            }
+            if (hash_megabytes < 1) hash_megabytes = 1;
+            if (limits.threads < 1) limits.threads = 1;
+
+            Board board;
+            if (!board.from_fen(fen)) {
+                std::cerr << "FEN inválida: " << fen << std::endl;
+                return 1;
+            }
+            TranspositionTable tt(size_t(hash_megabytes), huge_pages);
+            Search::Result result = Search::run(board, limits, tt);
+            std::cout << "Melhor movimento: "
+                      << move_to_string(result.best_move) << std::endl;
+            return 0;
+        }
 
-    if (file_char < 'a' || file_char > 'h' || rank_char < '1' ||
-        rank_char > '8') {
-        return -1;
+        if (command == "selfplay") {
+            const int games = (argc > 2) ? std::atoi(argv[2]) : 16;
+            const uint64_t nodes =
+                (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 20000;
+
+            Search::Limits a;
+            a.nodes = nodes;
+            Search::Limits b = parse_limits(a.depth, 4, argc, argv);
+            if (b.nodes == 0) b.nodes = nodes;
+
+            Bench::selfplay(games, a, b);
+            return 0;
+        }
+
+        if (command == "suite") {
+            return Perft::run_suite() ? 0 : 1;
+        }
+
+        std::cerr << "Comando desconhecido: " << command << std::endl;
+        return 1;
     }
-    int file_index = file_char - 'a';
-    int rank_index = rank_char - '1';
-    return rank_index * 8 + file_index;
-}
 
-int main() {
     Board game_board;
+    TranspositionTable game_tt(16);
     std::string user_input;
     std::vector<int> highlighted_squares;
 
@@ -51,6 +217,21 @@ int main() {
             break;
         }
 
+        // O motor joga pelo lado a mover
+        if (user_input == "go") {
+            Search::Limits limits;
+            limits.depth = 6;
+            limits.movetime_ms = 5000;
+            limits.threads = int(std::thread::hardware_concurrency());
+            Search::Result result = Search::run(game_board, limits, game_tt);
+            if (!result.best_move.is_null() &&
+                !game_board.make_move(result.best_move)) {
+                std::cerr << "Partida longa demais: o motor não pode jogar."
+                          << std::endl;
+            }
+            continue;
+        }
+
         if (user_input.length() == 2) {
             int from_square = algebraic_to_square(user_input);
             if (from_square != -1) {
@@ -65,35 +246,24 @@ int main() {
             continue;
         }
 
-        if (user_input.length() != 4) {
-            continue;
-        }
-
-        std::string from_square_str = user_input.substr(0, 2);
-        std::string to_square_str = user_input.substr(2, 2);
-
-        int from_square = algebraic_to_square(from_square_str);
-        int to_square = algebraic_to_square(to_square_str);
-
-        if (from_square == -1 || to_square == -1) {
+        // Movimento em notação de coordenadas ("e2e4"). Promoções podem
+        // indicar a peça ("e7e8n"); sem ela, promove para dama.
+        if (user_input.length() != 4 && user_input.length() != 5) {
             continue;
         }
 
-        Move user_move(from_square, to_square);
-        bool is_valid_move = false;
-
         std::vector<Move> legal_moves = MoveGen::gen_legal_moves(game_board);
 
         for (const Move& legal_mv : legal_moves) {
-            if (user_move == legal_mv) {
-                is_valid_move = true;
+            const std::string legal_text = move_to_string(legal_mv);
+            if (legal_text == user_input || legal_text == user_input + "q") {
+                if (!game_board.make_move(legal_mv)) {
+                    std::cerr << "Partida longa demais: movimento recusado."
+                              << std::endl;
+                }
                 break;
             }
         }
-
-        if (is_valid_move) {
-            game_board.make_move(user_move);
-        }
     }
 
     std::cout << "Exiting." << std::endl;
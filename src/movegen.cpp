@@ -1,17 +1,16 @@
 #include "movegen.h"
 
-#include <cmath>
+#include <algorithm>
+#include <mutex>
 
-namespace MoveGen {
-
-// Flag de inicialização das tabelas de ataques
-static bool table_attacks_ready = false;
+#include "attacks.h"
+#include "eval.h"
 
-// Tabela de ataques do rei
-static uint64_t king_attacks[64];
+namespace MoveGen {
 
-// Tabela de ataques dos cavalos
-static uint64_t knight_attacks[64];
+// Garante que as tabelas das peças deslizantes sejam inicializadas uma única
+// vez, mesmo que várias threads gerem movimentos ao mesmo tempo
+static std::once_flag tables_once;
 
 // Encontra o índice do bit menos significativo (LSB) em um bitboard
 inline int get_lsb(uint64_t bb) {
@@ -19,947 +18,854 @@ inline int get_lsb(uint64_t bb) {
     return __builtin_ctzll(bb);
 }
 
-// Inicializa a tabela de ataques do rei
-void init_king_attacks() {
-    // Itera sobre todas as casas do tabuleiro
-    for (int from = 0; from < 64; ++from) {
-        king_attacks[from] = 0ULL;
-        int from_file = from % 8;
+// Tabela de ataques de uma peça de salto (rei ou cavalo) por casa
+struct LeaperTable {
+    uint64_t attacks[64];
 
-        // Deltas para as 8 direções possíveis (norte, sul, leste, oeste,
-        // noroeste, nordeste, sudoeste, sudeste)
-        const int deltas[8] = {-1, +1, -8, +8, -9, -7, +7, +9};
+    inline uint64_t operator[](int square) const { return attacks[square]; }
+};
 
-        // Para cada direção possível
-        // (movimentos horizontais, verticais e diagonais)
-        for (int delta : deltas) {
-            int to = from + delta;
-
-            // Verifica se está dentro dos limites do tabuleiro
-            if (to >= 0 && to < 64) {
-                // Verifica se o movimento não dá a volta na borda do tabuleiro
-                int to_file = to % 8;
-                // Um movimento horizontal ou vertical válido não deve mudar a
-                // coluna em mais de 1 casa
-                if (std::abs(from_file - to_file) <= 1)
-                    king_attacks[from] |= (1ULL << to);
-            }
-        }
-    }
-}
-
-// Inicializa a tabela de ataques dos cavalos
-void init_knight_attacks() {
-    // Itera sobre todas as casas do tabuleiro
+// Monta a tabela de ataques de uma peça de salto a partir dos seus deltas.
+// max_file_distance descarta os saltos que dariam a volta na borda do
+// tabuleiro: a coluna de destino não pode se afastar mais do que isso.
+static constexpr LeaperTable make_leaper_table(const int (&deltas)[8],
+                                               int max_file_distance) {
+    LeaperTable table{};
     for (int from = 0; from < 64; ++from) {
-        knight_attacks[from] = 0ULL;
-        int from_file = from % 8;
-
-        // Deltas para os 8 saltos possíveis do cavalo
-        // (2 casas em uma direção e 1 casa na perpendicular)
-        const int deltas[8] = {17, 15, 10, 6, -17, -15, -10, -6};
-
-        // Para cada salto possível
         for (int delta : deltas) {
-            int to = from + delta;
-
-            // Verifica se está dentro dos limites do tabuleiro
-            if (to >= 0 && to < 64) {
-                // Verifica se o salto não dá a volta na borda do tabuleiro
-                int to_file = to % 8;
-                // A diferença de colunas para um salto de cavalo nunca pode ser
-                // maior que 2
-                if (std::abs(from_file - to_file) <= 2)
-                    knight_attacks[from] |= (1ULL << to);
+            const int to = from + delta;
+            if (to < 0 || to >= 64) continue;
+
+            const int file_distance = from % 8 - to % 8;
+            if (file_distance <= max_file_distance &&
+                -file_distance <= max_file_distance) {
+                table.attacks[from] |= 1ULL << to;
             }
         }
     }
+    return table;
 }
 
-// Verifica se uma casa está atacada por alguma peça do atacante
-bool is_square_attacked(int square, Color attacker, const Board& board) {
-    // Verifica ataques de Peões
-    const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;  // Exclui a coluna 'a'
-    const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;  // Exclui a coluna 'h'
-
-    // Obtém o bitboard de peões do atacante
-    const uint64_t pawns =
-        (attacker == WHITE) ? board.white_pawns : board.black_pawns;
-
-    // Peões brancos
-    if (attacker == WHITE) {
-        if ((1ULL << square) &
-            (((pawns & NOT_H_FILE) << 9) | ((pawns & NOT_A_FILE) << 7))) {
-            return true;
-        }
-    }
-    // Peões pretos
-    else {
-        if ((1ULL << square) &
-            (((pawns & NOT_A_FILE) >> 9) | ((pawns & NOT_H_FILE) >> 7))) {
-            return true;
-        }
-    }
+// Deltas para as 8 direções do rei (norte, sul, leste, oeste, noroeste,
+// nordeste, sudoeste, sudeste)
+static constexpr int KING_DELTAS[8] = {-1, +1, -8, +8, -9, -7, +7, +9};
+
+// Deltas para os 8 saltos do cavalo (2 casas em uma direção e 1 casa na
+// perpendicular)
+static constexpr int KNIGHT_DELTAS[8] = {17, 15, 10, 6, -17, -15, -10, -6};
+
+// Tabelas de ataques do rei e dos cavalos, calculadas na compilação. Como
+// são constantes, várias threads podem lê-las sem nenhuma inicialização.
+static constexpr LeaperTable king_attacks = make_leaper_table(KING_DELTAS, 1);
+static constexpr LeaperTable knight_attacks =
+    make_leaper_table(KNIGHT_DELTAS, 2);
+
+// Subconjunto dos movimentos legais a gerar: capturas e promoções
+// (CAPTURES), os demais (QUIETS), as respostas a um xeque (EVASIONS) ou
+// todos
+enum GenType { CAPTURES, QUIETS, EVASIONS, ALL_MOVES };
+
+// Máscaras para evitar que um peão "dê a volta" na borda do tabuleiro
+const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;  // Exclui a coluna 'a'
+const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;  // Exclui a coluna 'h'
+
+// Fileira onde o peão chega após o primeiro avanço a partir da casa inicial
+const uint64_t RANK_3 = 0x0000000000FF0000ULL;
+const uint64_t RANK_6 = 0x0000FF0000000000ULL;
+
+// Última fileira de cada cor, onde o peão é promovido
+const uint64_t RANK_1 = 0x00000000000000FFULL;
+const uint64_t RANK_8 = 0xFF00000000000000ULL;
+
+// Informações de cada cor conhecidas em tempo de compilação: o oponente, a
+// direção dos peões, as fileiras do avanço duplo e da promoção e os direitos
+// de roque.
+// Assim os geradores não precisam testar a cor a cada acesso.
+template <Color Us>
+struct Side;
+
+template <>
+struct Side<WHITE> {
+    static constexpr Color Them = BLACK;
+
+    static constexpr int UP = 8;         // Avanço (norte)
+    static constexpr int UP_RIGHT = 9;   // Captura para a coluna 'h' (nordeste)
+    static constexpr int UP_LEFT = 7;    // Captura para a coluna 'a' (noroeste)
+    static constexpr uint64_t DOUBLE_PUSH_RANK = RANK_3;
+    static constexpr uint64_t PROMOTION_RANK = RANK_8;
+    static constexpr uint8_t OO = WHITE_OO;
+    static constexpr uint8_t OOO = WHITE_OOO;
+};
+
+template <>
+struct Side<BLACK> {
+    static constexpr Color Them = WHITE;
+
+    static constexpr int UP = -8;        // Avanço (sul)
+    static constexpr int UP_RIGHT = -7;  // Captura para a coluna 'h' (sudeste)
+    static constexpr int UP_LEFT = -9;   // Captura para a coluna 'a' (sudoeste)
+    static constexpr uint64_t DOUBLE_PUSH_RANK = RANK_6;
+    static constexpr uint64_t PROMOTION_RANK = RANK_1;
+    static constexpr uint8_t OO = BLACK_OO;
+    static constexpr uint8_t OOO = BLACK_OOO;
+};
+
+// Desloca um bitboard na direção dada (positiva para cima, negativa para
+// baixo). Como a direção é constante, o compilador escolhe o shift certo.
+template <int Delta>
+inline uint64_t shift(uint64_t bb) {
+    return (Delta > 0) ? (bb << Delta) : (bb >> -Delta);
+}
 
-    // Obtém o bitboard de cavalos do atacante e verifica a tabela de ataques
-    // pré-calculada dos cavalos
-    const uint64_t knights =
-        (attacker == WHITE) ? board.white_knights : board.black_knights;
-    if (knight_attacks[square] & knights) return true;
-
-    // Obtém o bitboard do rei do atacante e verifica a tabela de ataques
-    // pré-calculada do rei
-    const uint64_t king =
-        (attacker == WHITE) ? board.white_king : board.black_king;
-    if (king_attacks[square] & king) return true;
-
-    // Obtém um bitboard que é a união de todas as peças deslizantes horizontais
-    // e verticais do atacante (torres e damas)
-    const uint64_t straight_sliders =
-        ((attacker == WHITE) ? board.white_rooks : board.black_rooks) |
-        ((attacker == WHITE) ? board.white_queens : board.black_queens);
-
-    // Verifica ataques de peças deslizantes horizontais e verticais
-    // Itera sobre as 4 direções possíveis (norte, sul, leste, oeste)
-    const int straight_deltas[4] = {8, -8, 1, -1};
-    for (int delta : straight_deltas) {
-        int current_square = square;
-        while (true) {
-            current_square += delta;  // Desliza na direção do delta
-
-            // Se ultrapassar os limites do tabuleiro, sai do loop
-            if (current_square < 0 || current_square >= 64) break;
-
-            // Verificação de "wrap-around" para movimentos horizontais
-            if ((delta == 1 || delta == -1) &&
-                (current_square / 8 != square / 8))
-                break;
-
-            // Cria uma máscara de bit para a casa atual
-            // e verifica se é atacada por uma peça deslizante
-            uint64_t current_bit = (1ULL << current_square);
-            if (straight_sliders & current_bit) return true;
-            if (board.all_occupied & current_bit) break;
-        }
+// Adiciona um movimento para cada destino do bitboard, com a origem a uma
+// distância fixa (Delta) do destino
+template <int Delta>
+inline void add_pawn_moves(uint64_t targets, MoveList& moves) {
+    while (targets) {
+        int to = get_lsb(targets);
+        moves.push_back(Move(to - Delta, to));
+        targets &= targets - 1;
     }
+}
 
-    // Obtém um bitboard que é a união de todas as peças deslizantes
-    // diagonais do atacante (bispos e damas)
-    const uint64_t diagonal_sliders =
-        ((attacker == WHITE) ? board.white_bishops : board.black_bishops) |
-        ((attacker == WHITE) ? board.white_queens : board.black_queens);
-
-    // Verifica ataques de peças deslizantes diagonais
-    // Itera sobre as 4 direções diagonais possíveis (noroeste, nordeste,
-    // sudoeste, sudeste)
-    const int diagonal_deltas[4] = {7, 9, -9, -7};
-    for (int delta : diagonal_deltas) {
-        int current_square = square;
-        while (true) {
-            current_square += delta;  // Desliza na direção do delta
-
-            // Se ultrapassar os limites do tabuleiro, sai do loop
-            if (current_square < 0 || current_square >= 64) break;
-
-            // Verificação de "wrap-around" para movimentos diagonais
-            int from_file = (current_square - delta) % 8;
-            int to_file = current_square % 8;
-            if (std::abs(from_file - to_file) != 1) break;
-
-            // Cria uma máscara de bit para a casa atual
-            // e verifica se é atacada por uma peça deslizante diagonal
-            uint64_t current_bit = (1ULL << current_square);
-            if (diagonal_sliders & current_bit) return true;
-            if (board.all_occupied & current_bit) break;
-        }
+// Adiciona as quatro promoções de cada destino do bitboard, começando pela
+// dama, que quase sempre é a melhor escolha
+template <int Delta>
+inline void add_promotions(uint64_t targets, MoveList& moves) {
+    while (targets) {
+        int to = get_lsb(targets);
+        moves.push_back(Move(to - Delta, to, MoveType::PROMOTION, PROMO_QUEEN));
+        moves.push_back(Move(to - Delta, to, MoveType::PROMOTION, PROMO_ROOK));
+        moves.push_back(
+            Move(to - Delta, to, MoveType::PROMOTION, PROMO_BISHOP));
+        moves.push_back(
+            Move(to - Delta, to, MoveType::PROMOTION, PROMO_KNIGHT));
+        targets &= targets - 1;
     }
-
-    // Se nenhuma das verificações encontrou um ataque, a casa está segura.
-    return false;
 }
 
-// Gera todos os movimentos válidos para os peões brancos
-std::vector<Move> gen_white_pawn_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
-
-    /**
-     * 1. Avanço simples (uma casa para frente)
-     */
-
-    // Simula todos os peões brancos avançando uma casa
-    uint64_t push_targets = (board.white_pawns << 8);
-
-    // Mantém apenas os movimentos para casas que estão vazias
-    uint64_t valid_pushes = push_targets & ~board.all_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    uint64_t remaining = valid_pushes;
-    while (remaining) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining);
-        int from = to - 8;
+// Adiciona os movimentos de peão que chegam em targets: os que chegam na
+// última fileira viram promoções
+template <Color Us, int Delta>
+inline void add_pawn_targets(uint64_t targets, MoveList& moves) {
+    add_pawn_moves<Delta>(targets & ~Side<Us>::PROMOTION_RANK, moves);
+    add_promotions<Delta>(targets & Side<Us>::PROMOTION_RANK, moves);
+}
 
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
+// Adiciona um movimento da casa de origem para cada destino do bitboard
+inline void add_moves(int from, uint64_t targets, MoveList& moves) {
+    while (targets) {
+        moves.push_back(Move(from, get_lsb(targets)));
+        targets &= targets - 1;
     }
+}
 
-    /**
-     * 2. Avanço duplo (duas casas para frente) quando o peão está na
-     * segunda fileira
-     */
-
-    // Mascara para identificar os peões brancos na segunda fileira
-    const uint64_t RANK_2 = 0x000000000000FF00ULL;
-
-    // Obtém os peões brancos que estão na segunda fileira
-    uint64_t rank2_pawns = board.white_pawns & RANK_2;
-
-    // Simula o avanço de uma casa e mantém apenas para casas vazias
-    uint64_t mid = (rank2_pawns << 8) & ~board.all_occupied;
-    uint64_t dbl_targets = (mid << 8) & ~board.all_occupied;
+// Retorna as peças da cor Them que atacam a casa, considerando a ocupação
+// dada. Passar uma ocupação diferente da do tabuleiro permite, por exemplo,
+// tirar o rei do caminho ao testar as casas para onde ele pode fugir.
+template <Color Them>
+static uint64_t attackers_to(int square, const Position& board,
+                             uint64_t occupied) {
+    using S = Side<Them>;
+    using U = Side<S::Them>;
+
+    const uint64_t bit = 1ULL << square;
+
+    // Um peão de Them ataca a casa se estiver em uma das casas que um peão
+    // do outro lado, parado nessa casa, capturaria
+    const uint64_t pawn_sources = shift<U::UP_RIGHT>(bit & NOT_H_FILE) |
+                                  shift<U::UP_LEFT>(bit & NOT_A_FILE);
+
+    const uint64_t queens = board.pieces[Them][QUEEN];
+
+    return (pawn_sources & board.pieces[Them][PAWN]) |
+           (knight_attacks[square] & board.pieces[Them][KNIGHT]) |
+           (king_attacks[square] & board.pieces[Them][KING]) |
+           (Attacks::rook_attacks(square, occupied) &
+            (board.pieces[Them][ROOK] | queens)) |
+           (Attacks::bishop_attacks(square, occupied) &
+            (board.pieces[Them][BISHOP] | queens));
+}
 
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    remaining = dbl_targets;
-    while (remaining) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining);
-        int from = to - 16;
+// Verifica se uma casa está atacada por alguma peça do atacante
+template <Color Attacker>
+bool is_square_attacked(int square, const Position& board) {
+    return attackers_to<Attacker>(square, board, board.all_occupied) != 0;
+}
 
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
-    }
+bool is_square_attacked(int square, Color attacker, const Position& board) {
+    return (attacker == WHITE) ? is_square_attacked<WHITE>(square, board)
+                               : is_square_attacked<BLACK>(square, board);
+}
 
-    /**
-     * 3. Capturas Diagonais
-     */
+bool in_check(const Position& board) {
+    const uint64_t king = board.pieces[board.turn][KING];
+    if (king == 0) return false;
+    return (board.turn == WHITE)
+               ? is_square_attacked<BLACK>(get_lsb(king), board)
+               : is_square_attacked<WHITE>(get_lsb(king), board);
+}
 
-    // Máscara para evitar que um peão "dê a volta" na borda do tabuleiro
-    const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;  // Exclui a coluna 'a'
-    const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;  // Exclui a coluna 'h'
-
-    // Capturas para a direita (nordeste, delta +9)
-    // Primeiro, pegamos os peões que não estão na coluna 'h' e os deslocamos
-    // para o alvo do ataque.
-    uint64_t attack_targets_right = (board.white_pawns & NOT_H_FILE) << 9;
-    // Movimento só é válido se o alvo estiver ocupado por uma peça preta.
-    uint64_t valid_captures_right = attack_targets_right & board.black_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    uint64_t remaining_captures = valid_captures_right;
-    while (remaining_captures) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining_captures);
-        int from = to - 9;
-
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining_captures &= remaining_captures - 1;
-    }
+// Retorna as peças da cor Us cravadas no próprio rei: a única peça entre o
+// rei e uma torre, bispo ou dama do oponente alinhada com ele
+template <Color Us>
+static uint64_t pinned_pieces(const Position& board, int king_square) {
+    using S = Side<Us>;
+
+    const uint64_t them = board.occupied[S::Them];
+    const uint64_t their_queens = board.pieces[S::Them][QUEEN];
+
+    // Peças do oponente que atacariam o rei se as nossas peças não
+    // estivessem no caminho
+    uint64_t snipers =
+        (Attacks::rook_attacks(king_square, them) &
+         (board.pieces[S::Them][ROOK] | their_queens)) |
+        (Attacks::bishop_attacks(king_square, them) &
+         (board.pieces[S::Them][BISHOP] | their_queens));
+
+    uint64_t pinned = 0ULL;
+    while (snipers) {
+        const int sniper = get_lsb(snipers);
+        const uint64_t blockers =
+            Attacks::between(king_square, sniper) & board.all_occupied;
+
+        // Exatamente uma peça no caminho e ela é nossa: está cravada
+        if (blockers && !(blockers & (blockers - 1))) {
+            pinned |= blockers & board.occupied[Us];
+        }
 
-    // Capturas para a esquerda (noroeste, delta +7)
-    // Primeiro, pegamos os peões que não estão na coluna 'a' e os deslocamos
-    // para o alvo do ataque.
-    uint64_t attack_targets_left = (board.white_pawns & NOT_A_FILE) << 7;
-    // Movimento só é válido se o alvo estiver ocupado por uma peça preta.
-    uint64_t valid_captures_left = attack_targets_left & board.black_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    remaining_captures = valid_captures_left;
-    while (remaining_captures) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining_captures);
-        int from = to - 7;
-
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining_captures &= remaining_captures - 1;
+        snipers &= snipers - 1;
     }
 
-    return moves;
+    return pinned;
 }
 
-// Gera todos os movimentos válidos para os peões pretos
-std::vector<Move> gen_black_pawn_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
+// Adiciona os avanços e capturas de um conjunto de peões, mantendo apenas os
+// destinos que estão em target. As promoções, mesmo sem captura, contam como
+// CAPTURES: mudam o material como uma captura.
+template <Color Us, GenType Type>
+static void add_pawn_set_moves(uint64_t pawns, uint64_t empty,
+                               uint64_t enemies, uint64_t target,
+                               MoveList& moves) {
+    using S = Side<Us>;
 
     /**
-     * 1. Avanço simples (uma casa para frente)
+     * 1. Avanço simples (uma casa para frente), com promoção ao chegar na
+     * última fileira
      */
 
-    // Simula todos os peões pretos avançando uma casa
-    uint64_t push_targets = (board.black_pawns >> 8);
-
-    // Mantém apenas os movimentos para casas que estão vazias
-    uint64_t valid_pushes = push_targets & ~board.all_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    uint64_t remaining = valid_pushes;
-    while (remaining) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining);
-        int from = to + 8;
-
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
-    }
-
-    /**
-     * 2. Avanço duplo (duas casas para frente) quando o peão está na
-     * sétima fileira
-     */
-
-    // Mascara para identificar os peões pretos na sétima fileira
-    const uint64_t RANK_7 = 0x00FF000000000000ULL;
-
-    // Obtém os peões pretos que estão na sétima fileira
-    uint64_t rank7_pawns = board.black_pawns & RANK_7;
+    // Simula todos os peões avançando uma casa e mantém apenas os
+    // movimentos para casas que estão vazias
+    const uint64_t single_pushes = shift<S::UP>(pawns) & empty;
 
-    // Simula o avanço de uma casa e mantém apenas para casas vazias
-    uint64_t mid = (rank7_pawns >> 8) & ~board.all_occupied;
-    uint64_t dbl_targets = (mid >> 8) & ~board.all_occupied;
+    if (Type != CAPTURES) {
+        add_pawn_moves<S::UP>(single_pushes & target & ~S::PROMOTION_RANK,
+                              moves);
 
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    remaining = dbl_targets;
-    while (remaining) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining);
-        int from = to + 16;
+        /**
+         * 2. Avanço duplo (duas casas para frente) quando o peão está na
+         * casa inicial
+         */
 
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
+        // Os peões que avançaram uma casa a partir da casa inicial estão na
+        // terceira fileira (sexta para as pretas); avança mais uma casa
+        const uint64_t double_pushes =
+            shift<S::UP>(single_pushes & S::DOUBLE_PUSH_RANK) & empty;
+        add_pawn_moves<2 * S::UP>(double_pushes & target, moves);
     }
 
-    /**
-     * 3. Capturas Diagonais
-     */
-
-    // Máscara para evitar que um peão "dê a volta" na borda do tabuleiro
-    const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;  // Exclui a coluna 'a'
-    const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;  // Exclui a coluna 'h'
-
-    // Capturas para a esquerda (sudoeste, delta -9)
-    // Primeiro, pegamos os peões que não estão na coluna 'a' e os deslocamos
-    // para o alvo do ataque.
-    uint64_t attack_targets_left = (board.black_pawns & NOT_A_FILE) >> 9;
-    // Movimento só é válido se o alvo estiver ocupado por uma peça branca.
-    uint64_t valid_captures_left = attack_targets_left & board.white_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    uint64_t remaining_captures = valid_captures_left;
-    while (remaining_captures) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining_captures);
-        int from = to + 9;
-
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
+    if (Type != QUIETS) {
+        add_promotions<S::UP>(single_pushes & target & S::PROMOTION_RANK,
+                              moves);
+
+        /**
+         * 3. Capturas Diagonais
+         */
+
+        // Capturas em direção à coluna 'h': os peões da coluna 'h' são
+        // excluídos antes do deslocamento. O alvo precisa ter uma peça do
+        // oponente.
+        const uint64_t captures_right =
+            shift<S::UP_RIGHT>(pawns & NOT_H_FILE) & enemies;
+        add_pawn_targets<Us, S::UP_RIGHT>(captures_right & target, moves);
+
+        // Capturas em direção à coluna 'a'
+        const uint64_t captures_left =
+            shift<S::UP_LEFT>(pawns & NOT_A_FILE) & enemies;
+        add_pawn_targets<Us, S::UP_LEFT>(captures_left & target, moves);
     }
-
-    // Capturas para a direita (sudeste, delta -7)
-    uint64_t attack_targets_right = (board.black_pawns & NOT_H_FILE) >> 7;
-    // Movimento só é válido se o alvo estiver ocupado por uma peça branca.
-    uint64_t valid_captures_right = attack_targets_right & board.white_occupied;
-
-    // Itera sobre os destinos válidos e adiciona os movimentos
-    // Enquanto houver bits '1' (movimentos válidos)
-    remaining_captures = valid_captures_right;
-    while (remaining_captures) {
-        // Calcula o índice do destino e da origem
-        int to = get_lsb(remaining_captures);
-        int from = to + 7;
-
-        // Adiciona o movimento à lista e remove o bit processado
-        moves.push_back(Move(from, to));
-        remaining_captures &= remaining_captures - 1;
-    }
-
-    return moves;
 }
 
-// Gera todos os movimentos válidos para o rei branco
-std::vector<Move> gen_white_king_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
-
-    // Obtém o rei branco do estado do tabuleiro
-    uint64_t king = board.white_king;
-
-    // Se não houver rei branco (em um fluxo normal, isso não deve acontecer),
-    // retorna um vetor vazio
-    if (king == 0) return moves;
-
-    // Encontra a posição do rei branco (único bit 1 no bitboard)
-    int from = get_lsb(king);
-
-    // Obtém todos os movimentos possíveis do rei nessa casa
-    // e mantém apenas os que não colidem com peças brancas
-    uint64_t targets = king_attacks[from] & ~board.white_occupied;
-
-    // Itera sobre cada movimento válido
-    uint64_t remaining = targets;
-    while (remaining) {
-        int to = get_lsb(remaining);
-
-        // Adiciona o movimento à lista e remove o movimento processado
-        // do bitboard de movimentos restantes
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
+// Os geradores abaixo recebem as restrições da geração legal:
+// - target: casas de destino permitidas (em xeque, bloquear ou capturar)
+// - pinned: peças cravadas, que só podem andar sobre a linha até o rei
+// - king_square: casa do próprio rei, usada para achar essa linha
+// Na geração pseudo-legal, target só exclui as próprias peças e não há
+// peças cravadas. Os peões recebem também o tipo de geração, pois uma
+// promoção sem captura vai para uma casa vazia.
+
+template <Color Us, GenType Type>
+static void pawn_moves(const Position& board, uint64_t target, uint64_t pinned,
+                       int king_square, MoveList& moves) {
+    using S = Side<Us>;
+
+    const uint64_t pawns = board.pieces[Us][PAWN];
+    const uint64_t empty = ~board.all_occupied;
+    const uint64_t enemies = board.occupied[S::Them];
+
+    // Peões livres são gerados todos de uma vez
+    add_pawn_set_moves<Us, Type>(pawns & ~pinned, empty, enemies, target,
+                                 moves);
+
+    // Peões cravados são gerados um a um, presos à linha da cravada
+    uint64_t pinned_pawns = pawns & pinned;
+    while (pinned_pawns) {
+        const int from = get_lsb(pinned_pawns);
+        add_pawn_set_moves<Us, Type>(1ULL << from, empty, enemies,
+                                     target & Attacks::line(king_square, from),
+                                     moves);
+        pinned_pawns &= pinned_pawns - 1;
     }
-
-    return moves;
 }
 
-// Gera todos os movimentos válidos para o rei preto
-std::vector<Move> gen_black_king_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
-
-    // Obtém o rei preto do estado do tabuleiro
-    uint64_t king = board.black_king;
-
-    // Se não houver rei preto (em um fluxo normal, isso não deve acontecer),
-    // retorna um vetor vazio
-    if (king == 0) return moves;
-
-    // Encontra a posição do rei preto (único bit 1 no bitboard)
-    int from = get_lsb(king);
-
-    // Obtém todos os movimentos possíveis do rei nessa casa
-    // e mantém apenas os que não colidem com peças pretas
-    uint64_t targets = king_attacks[from] & ~board.black_occupied;
-
-    // Itera sobre cada movimento válido
-    uint64_t remaining = targets;
-    while (remaining) {
-        int to = get_lsb(remaining);
-
-        // Adiciona o movimento à lista e remove o movimento processado
-        // do bitboard de movimentos restantes
-        moves.push_back(Move(from, to));
-        remaining &= remaining - 1;
-    }
-
-    return moves;
-}
+template <Color Us>
+static void knight_moves(const Position& board, uint64_t target,
+                         uint64_t pinned, MoveList& moves) {
+    // Um cavalo cravado nunca pode se mover sem sair da linha
+    uint64_t knights = board.pieces[Us][KNIGHT] & ~pinned;
 
-// Gera todos os movimentos válidos para os cavalos brancos
-std::vector<Move> gen_white_knight_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
-
-    // Pega o bitboard de todos os cavalos brancos
-    uint64_t knights = board.white_knights;
-
-    // Em um fluxo normal de jogo, a tabela de ataques dos cavalos já deve
-    // ter sido inicializada se chegou aqui.
-
-    // Itera sobre cada cavalo branco no tabuleiro
+    // Itera sobre cada cavalo no tabuleiro
     while (knights) {
-        // Pega a casa do cavalo branco atual (o bit menos significativo)
+        // Pega a casa do cavalo atual (o bit menos significativo)
         int from = get_lsb(knights);
 
         // Obtém todos os saltos possíveis do cavalo nessa casa e mantém apenas
-        // os que não colidem com peças brancas
-        uint64_t targets = knight_attacks[from] & ~board.white_occupied;
-
-        // Itera sobre cada salto válido
-        uint64_t remaining = targets;
-        while (remaining) {
-            int to = get_lsb(remaining);
-
-            // Adiciona o movimento à lista e remove o bit processado
-            moves.push_back(Move(from, to));
-            remaining &= remaining - 1;
-        }
+        // os destinos permitidos
+        add_moves(from, knight_attacks[from] & target, moves);
 
         // Remove o cavalo processado do bitboard
         knights &= knights - 1;
     }
-
-    return moves;
 }
 
-// Gera todos os movimentos válidos para os cavalos pretos
-std::vector<Move> gen_black_knight_moves(const Board& board) {
-    std::vector<Move> moves;
-
-    uint64_t knights = board.black_knights;
-    while (knights) {
-        // Pega a casa do cavalo preto atual (o bit menos significativo)
-        int from = get_lsb(knights);
+// Gera os movimentos das peças deslizantes de um bitboard, usando a função
+// de consulta de ataques correspondente (torre, bispo ou dama)
+template <uint64_t (*SliderAttacks)(int, uint64_t)>
+static void slider_moves(uint64_t pieces, uint64_t occupied, uint64_t target,
+                         uint64_t pinned, int king_square, MoveList& moves) {
+    // Itera sobre cada peça no tabuleiro
+    while (pieces) {
+        int from = get_lsb(pieces);
+
+        // Consulta a tabela de ataques com a ocupação atual e mantém apenas
+        // os destinos permitidos
+        uint64_t targets = SliderAttacks(from, occupied) & target;
+
+        // Uma peça cravada só pode deslizar sobre a linha da cravada
+        if (pinned & (1ULL << from)) {
+            targets &= Attacks::line(king_square, from);
+        }
 
-        // Obtém todos os saltos possíveis do cavalo nessa casa e mantém apenas
-        // os que não colidem com peças pretas
-        uint64_t targets = knight_attacks[from] & ~board.black_occupied;
+        add_moves(from, targets, moves);
 
-        // Itera sobre cada salto válido
-        uint64_t remaining = targets;
-        while (remaining) {
-            int to = get_lsb(remaining);
+        // Remove a peça processada do bitboard
+        pieces &= pieces - 1;
+    }
+}
 
-            // Adiciona o movimento à lista e remove o bit processado
-            moves.push_back(Move(from, to));
-            remaining &= remaining - 1;
+// Capturas en passant. São raras, então cada uma é testada (na geração
+// legal) refazendo a ocupação depois da captura: isso cobre de uma vez o
+// xeque, as cravadas e o caso em que os dois peões saem da fileira do rei.
+template <Color Us, bool Legal>
+static void en_passant_moves(const Position& board, int king_square,
+                             MoveList& moves) {
+    using S = Side<Us>;
+    using T = Side<S::Them>;
+
+    if (board.en_passant_square == NO_SQUARE) return;
+
+    const int to = board.en_passant_square;
+    const uint64_t to_bit = 1ULL << to;
+    const uint64_t captured_bit = 1ULL << (to - S::UP);
+
+    // Nossos peões que atacam a casa estão onde um peão do oponente, parado
+    // nela, capturaria
+    uint64_t pawns = (shift<T::UP_RIGHT>(to_bit & NOT_H_FILE) |
+                      shift<T::UP_LEFT>(to_bit & NOT_A_FILE)) &
+                     board.pieces[Us][PAWN];
+
+    while (pawns) {
+        const int from = get_lsb(pawns);
+        pawns &= pawns - 1;
+
+        if (Legal) {
+            const uint64_t occupied =
+                (board.all_occupied ^ (1ULL << from) ^ captured_bit) | to_bit;
+            if (attackers_to<S::Them>(king_square, board, occupied) &
+                ~captured_bit) {
+                continue;
+            }
         }
 
-        // Remove o cavalo processado do bitboard
-        knights &= knights - 1;
+        moves.push_back(Move(from, to, MoveType::EN_PASSANT));
     }
-
-    return moves;
 }
 
-// Gera todos os movimentos válidos para as torres brancas
-std::vector<Move> gen_white_rook_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
-
-    // Pega o bitboard de todas as torres brancas
-    uint64_t rooks = board.white_rooks;
-
-    // Itera sobre cada torre branca no tabuleiro
-    while (rooks) {
-        int from_square = get_lsb(rooks);
+// Roques da cor Us. Quem chama garante que o rei não está em xeque. As casas
+// entre o rei e a torre precisam estar vazias e o rei não pode passar por
+// nem terminar em uma casa atacada.
+template <Color Us>
+static void castling_moves(const Position& board, int king_square,
+                           MoveList& moves) {
+    using S = Side<Us>;
+
+    // O rei sai da ocupação para que uma torre ou dama na mesma fileira
+    // ataque as casas "atrás" dele
+    const uint64_t occupied = board.all_occupied ^ (1ULL << king_square);
+
+    if ((board.castling_rights & S::OO) &&
+        !(Attacks::between(king_square, king_square + 3) &
+          board.all_occupied) &&
+        !attackers_to<S::Them>(king_square + 1, board, occupied) &&
+        !attackers_to<S::Them>(king_square + 2, board, occupied)) {
+        moves.push_back(
+            Move(king_square, king_square + 2, MoveType::CASTLING));
+    }
 
-        // Deltas para as 4 direções possíveis (norte, sul, leste, oeste)
-        const int deltas[4] = {8, -8, 1, -1};
+    if ((board.castling_rights & S::OOO) &&
+        !(Attacks::between(king_square, king_square - 4) &
+          board.all_occupied) &&
+        !attackers_to<S::Them>(king_square - 1, board, occupied) &&
+        !attackers_to<S::Them>(king_square - 2, board, occupied)) {
+        moves.push_back(
+            Move(king_square, king_square - 2, MoveType::CASTLING));
+    }
+}
 
-        // Para cada uma das 4 direções
-        for (int delta : deltas) {
-            int to_square = from_square;  // Posição inicial da torre
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;  // Move uma casa na direção
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // (ex: de h1 para a2)
-                int from_file = (to_square - delta) % 8;
-                int to_file = to_square % 8;
-                // Um movimento horizontal ou vertical válido não deve mudar a
-                // coluna em mais de 1 casa
-                if (std::abs(from_file - to_file) > 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // não pode mover para lá e sai o loop
-                if (board.white_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // adiciona o movimento e sai do loop
-                if (board.black_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento
-                // e continua deslizando na mesma direção
-                moves.push_back(Move(from_square, to_square));
-            }
-        }
+// Gera todos os movimentos pseudo-legais para os peões da cor Us
+template <Color Us>
+void gen_pawn_moves(const Position& board, MoveList& moves) {
+    pawn_moves<Us, ALL_MOVES>(board, ~0ULL, 0ULL, 0, moves);
+    en_passant_moves<Us, false>(board, 0, moves);
+}
 
-        // Remove a torre processada do bitboard
-        rooks &= rooks - 1;
+// Gera todos os movimentos pseudo-legais para o rei da cor Us
+template <Color Us>
+void gen_king_moves(const Position& board, MoveList& moves) {
+    // Obtém o rei do estado do tabuleiro
+    const uint64_t king = board.pieces[Us][KING];
+
+    // Se não houver rei (em um fluxo normal, isso não deve acontecer),
+    // não há movimentos para adicionar
+    if (king == 0) return;
+
+    // Encontra a posição do rei (único bit 1 no bitboard), obtém todos os
+    // movimentos possíveis nessa casa e mantém apenas os que não colidem com
+    // peças da própria cor
+    const int from = get_lsb(king);
+    add_moves(from, king_attacks[from] & ~(board.occupied[Us]), moves);
+
+    // Roque não pode ser usado para sair do xeque
+    if ((board.castling_rights & (Side<Us>::OO | Side<Us>::OOO)) &&
+        !attackers_to<Side<Us>::Them>(from, board, board.all_occupied)) {
+        castling_moves<Us>(board, from, moves);
     }
+}
 
-    return moves;
+// Gera todos os movimentos pseudo-legais para os cavalos da cor Us
+template <Color Us>
+void gen_knight_moves(const Position& board, MoveList& moves) {
+    knight_moves<Us>(board, ~(board.occupied[Us]), 0ULL, moves);
 }
 
-// Gera todos os movimentos válidos para as torres pretas
-std::vector<Move> gen_black_rook_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
+// Gera todos os movimentos pseudo-legais para as torres da cor Us
+template <Color Us>
+void gen_rook_moves(const Position& board, MoveList& moves) {
+    slider_moves<Attacks::rook_attacks>(board.pieces[Us][ROOK],
+                                        board.all_occupied,
+                                        ~(board.occupied[Us]), 0ULL, 0, moves);
+}
 
-    // Pega o bitboard de todas as torres pretas
-    uint64_t rooks = board.black_rooks;
+// Gera todos os movimentos pseudo-legais para os bispos da cor Us
+template <Color Us>
+void gen_bishop_moves(const Position& board, MoveList& moves) {
+    slider_moves<Attacks::bishop_attacks>(board.pieces[Us][BISHOP],
+                                          board.all_occupied,
+                                          ~(board.occupied[Us]), 0ULL, 0,
+                                          moves);
+}
+
+// Gera todos os movimentos pseudo-legais para as damas da cor Us
+template <Color Us>
+void gen_queen_moves(const Position& board, MoveList& moves) {
+    slider_moves<Attacks::queen_attacks>(board.pieces[Us][QUEEN],
+                                         board.all_occupied,
+                                         ~(board.occupied[Us]), 0ULL, 0,
+                                         moves);
+}
 
-    // Itera sobre cada torre preta no tabuleiro
-    while (rooks) {
-        int from_square = get_lsb(rooks);
+// Inicializa as tabelas das peças deslizantes se ainda não estiverem
+// prontas (as do rei e dos cavalos já vêm prontas da compilação). As outras
+// threads esperam a inicialização terminar; depois disso as tabelas só são
+// lidas.
+void init_tables() {
+    std::call_once(tables_once, [] { Attacks::init(); });
+}
 
-        // Delta para as 4 direções possíveis (norte, sul, leste, oeste)
-        const int deltas[4] = {8, -8, 1, -1};
+// Gera todos os movimentos pseudo-legais da cor Us. Cada gerador adiciona os
+// movimentos do seu conjunto de peças diretamente na lista.
+template <Color Us>
+static void gen_all_moves(const Position& board, MoveList& moves) {
+    gen_pawn_moves<Us>(board, moves);
+    gen_king_moves<Us>(board, moves);
+    gen_knight_moves<Us>(board, moves);
+    gen_rook_moves<Us>(board, moves);
+    gen_bishop_moves<Us>(board, moves);
+    gen_queen_moves<Us>(board, moves);
+}
 
-        for (int delta : deltas) {
-            int to_square = from_square;  // Posição inicial da torre
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;  // Move uma casa na direção
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // (ex: de h1 para a2)
-                int from_file = (to_square - delta) % 8;
-                int to_file = to_square % 8;
-                // Um movimento horizontal ou vertical válido não deve mudar a
-                // coluna em mais de 1 casa
-                if (std::abs(from_file - to_file) > 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // não pode mover para lá e sai do loop
-                if (board.black_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // adiciona o movimento e sai do loop
-                if (board.white_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento e continua deslizando
-                // na mesma direção
-                moves.push_back(Move(from_square, to_square));
-            }
+// Gera apenas os movimentos legais da cor Us, sem fazer e desfazer cada um.
+// As peças que dão xeque e as peças cravadas são calculadas uma vez e
+// restringem os destinos de cada gerador, junto com o tipo de geração
+// (casas do oponente para CAPTURES, casas vazias para QUIETS).
+template <Color Us, GenType Type>
+static void gen_legal_moves(const Position& board, MoveList& moves) {
+    using S = Side<Us>;
+    constexpr Color Them = S::Them;
+
+    const uint64_t own = board.occupied[Us];
+    const uint64_t king = board.pieces[Us][KING];
+
+    // Sem rei (não acontece em um jogo normal) nenhum movimento o expõe
+    if (king == 0) {
+        if (Type == ALL_MOVES || Type == EVASIONS) {
+            gen_all_moves<Us>(board, moves);
         }
-
-        // Remove a torre processada do bitboard
-        rooks &= rooks - 1;
+        return;
     }
 
-    return moves;
-}
+    // Destinos permitidos pelo tipo de geração (em EVASIONS a restrição
+    // vem das peças que dão xeque, logo abaixo)
+    const uint64_t type_target = (Type == CAPTURES) ? board.occupied[Them]
+                                 : (Type == QUIETS) ? ~board.all_occupied
+                                                    : ~own;
 
-// Gera todos os movimentos válidos para os bispos brancos
-std::vector<Move> gen_white_bishop_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
+    const int king_square = get_lsb(king);
+    const uint64_t checkers =
+        attackers_to<Them>(king_square, board, board.all_occupied);
 
-    // Pega o bitboard de todos os bispos brancos
-    uint64_t bishops = board.white_bishops;
-
-    // Itera sobre cada bispo branco no tabuleiro
-    while (bishops) {
-        int from_square = get_lsb(bishops);
+    /**
+     * 1. Rei: cada destino é testado com o rei fora do tabuleiro, para que
+     * ele não "fuja" na mesma linha de uma peça deslizante que o ataca
+     */
+    const uint64_t occupied_without_king = board.all_occupied ^ king;
+    uint64_t king_targets = king_attacks[king_square] & type_target;
+    while (king_targets) {
+        const int to = get_lsb(king_targets);
+        if (!attackers_to<Them>(to, board, occupied_without_king)) {
+            moves.push_back(Move(king_square, to));
+        }
+        king_targets &= king_targets - 1;
+    }
 
-        // Deltas para as 4 direções diagonais:
-        // Noroeste, Nordeste, Sudoeste, Sudeste
-        const int deltas[4] = {7, 9, -9, -7};
+    // Em xeque duplo só o rei pode se mover
+    if (checkers & (checkers - 1)) return;
 
-        // Para cada uma das 4 direções diagonais
-        for (int delta : deltas) {
-            int to_square = from_square;
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;  // Move uma casa na direção
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // (ex: de h1 para a2)
-                int from_file = (to_square - delta) % 8;
-                int to_file = to_square % 8;
-                // Um movimento diagonal válido não deve mudar a coluna
-                // em mais de 1 casa
-                if (std::abs(from_file - to_file) != 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // não pode mover para lá e sai do loop
-                if (board.white_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // adiciona o movimento e sai do loop
-                if (board.black_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento e continua deslizando
-                // na mesma direção
-                moves.push_back(Move(from_square, to_square));
-            }
-        }
+    /**
+     * 2. Demais peças: em xeque simples, só podem capturar a peça que dá
+     * xeque ou se colocar entre ela e o rei
+     */
+    uint64_t target = ~own;
+    if (checkers) {
+        target &= checkers | Attacks::between(king_square, get_lsb(checkers));
+    }
 
-        // Remove o bispo processado do bitboard
-        bishops &= bishops - 1;
+    // Sem xeque, o rei ainda pode rocar
+    if (Type != CAPTURES && Type != EVASIONS && !checkers &&
+        (board.castling_rights & (S::OO | S::OOO))) {
+        castling_moves<Us>(board, king_square, moves);
     }
 
-    return moves;
+    const uint64_t pinned = pinned_pieces<Us>(board, king_square);
+
+    pawn_moves<Us, Type>(board, target, pinned, king_square, moves);
+    if (Type != QUIETS) en_passant_moves<Us, true>(board, king_square, moves);
+
+    // As peças comuns só precisam do destino restrito pelo tipo
+    target &= type_target;
+    knight_moves<Us>(board, target, pinned, moves);
+    slider_moves<Attacks::rook_attacks>(board.pieces[Us][ROOK],
+                                        board.all_occupied, target, pinned,
+                                        king_square, moves);
+    slider_moves<Attacks::bishop_attacks>(board.pieces[Us][BISHOP],
+                                          board.all_occupied, target, pinned,
+                                          king_square, moves);
+    slider_moves<Attacks::queen_attacks>(board.pieces[Us][QUEEN],
+                                         board.all_occupied, target, pinned,
+                                         king_square, moves);
 }
 
-// Gera todos os movimentos válidos para os bispos pretos
-std::vector<Move> gen_black_bishop_moves(const Board& board) {
-    std::vector<Move> moves;  // Vetor para armazenar os movimentos válidos
+// Gera todos os movimentos pseudo-legais para o jogador atual
+void gen_all_moves(const Position& board, MoveList& moves) {
+    init_tables();
 
-    // Pega o bitboard de todos os bispos pretos
-    uint64_t bishops = board.black_bishops;
-
-    // Itera sobre cada bispo preto no tabuleiro
-    while (bishops) {
-        int from_square = get_lsb(bishops);
-
-        // Deltas para as 4 direções diagonais:
-        // Noroeste, Nordeste, Sudoeste, Sudeste
-        const int deltas[4] = {7, 9, -9, -7};
+    // A cor é decidida uma única vez; daqui para baixo tudo é especializado
+    if (board.turn == WHITE) {
+        gen_all_moves<WHITE>(board, moves);
+    } else {
+        gen_all_moves<BLACK>(board, moves);
+    }
+}
 
-        // Para cada uma das 4 direções diagonais
-        for (int delta : deltas) {
-            int to_square = from_square;
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;  // Move uma casa na direção
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // (ex: de h1 para a2)
-                int from_file = (to_square - delta) % 8;
-                int to_file = to_square % 8;
-                // Um movimento diagonal válido não deve mudar a coluna
-                // em mais de 1 casa
-                if (std::abs(from_file - to_file) != 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // não pode mover para lá e sai do loop
-                if (board.black_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // adiciona o movimento e sai do loop
-                if (board.white_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento e continua deslizando
-                // na mesma direção
-                moves.push_back(Move(from_square, to_square));
-            }
-        }
+// Escolhe a cor uma única vez; daqui para baixo tudo é especializado
+template <GenType Type>
+static inline void gen_legal_for_turn(const Position& board,
+                                      MoveList& moves) {
+    init_tables();
 
-        // Remove o bispo processado do bitboard
-        bishops &= bishops - 1;
+    if (board.turn == WHITE) {
+        gen_legal_moves<WHITE, Type>(board, moves);
+    } else {
+        gen_legal_moves<BLACK, Type>(board, moves);
     }
-
-    return moves;
 }
 
-// Gera todos os movimentos válidos para as damas brancas
-std::vector<Move> gen_white_queen_moves(const Board& board) {
-    std::vector<Move> moves;
-    uint64_t queens = board.white_queens;
+// Gera todos os movimentos legais para o jogador atual
+void gen_legal_moves(const Position& board, MoveList& moves) {
+    gen_legal_for_turn<ALL_MOVES>(board, moves);
+}
 
-    // Itera sobre cada dama branca no tabuleiro
-    while (queens) {
-        int from_square = get_lsb(queens);
+void gen_captures(const Position& board, MoveList& moves) {
+    gen_legal_for_turn<CAPTURES>(board, moves);
+}
 
-        // Deltas para as 8 direções possíveis:
-        const int deltas[8] = {8, -8, 1,  -1,   // Retas (Torre)
-                               7, 9,  -9, -7};  // Diagonais (Bispo)
+void gen_quiets(const Position& board, MoveList& moves) {
+    gen_legal_for_turn<QUIETS>(board, moves);
+}
 
-        // Para cada uma das 8 direções
-        for (int delta : deltas) {
-            int to_square = from_square;
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // Mesma lógica que as torres e bispos
-                int from_file_of_step = (to_square - delta) % 8;
-                int to_file_of_step = to_square % 8;
-                // Um movimento diagonal, horizontal ou vertical válido
-                // não deve mudar a coluna em mais de 1 casa
-                if (std::abs(from_file_of_step - to_file_of_step) > 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // não pode mover para lá e sai do loop
-                if (board.white_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // adiciona o movimento e sai do loop
-                if (board.black_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento e continua deslizando
-                // na mesma direção
-                moves.push_back(Move(from_square, to_square));
-            }
-        }
+void gen_evasions(const Position& board, MoveList& moves) {
+    gen_legal_for_turn<EVASIONS>(board, moves);
+}
 
-        queens &= queens - 1;  // Remove a dama processada do bitboard
-    }
+// Verifica se o movimento pode ser feito pela peça na origem, ignorando se
+// ele deixa o próprio rei em xeque
+template <Color Us>
+static bool is_pseudo_legal(const Position& board, Move move) {
+    using S = Side<Us>;
 
-    return moves;
-}
+    const int from = move.from();
+    const int to = move.to();
+    const Piece piece = board.piece_on(from);
+    if (piece == NO_PIECE || color_of(piece) != Us) return false;
 
-// Gera todos os movimentos válidos para as damas pretas
-std::vector<Move> gen_black_queen_moves(const Board& board) {
-    std::vector<Move> moves;
-    uint64_t queens = board.black_queens;
+    const uint64_t to_bit = 1ULL << to;
+    if (board.occupied[Us] & to_bit) return false;
 
-    // Itera sobre cada dama preta no tabuleiro
-    while (queens) {
-        int from_square = get_lsb(queens);
+    const PieceType type = type_of(piece);
 
-        // Deltas para as 8 direções possíveis:
-        const int deltas[8] = {8, -8, 1,  -1,   // Retas (Torre)
-                               7, 9,  -9, -7};  // Diagonais (Bispo)
+    // Só promoções usam os bits da peça promovida
+    if (move.type() != MoveType::PROMOTION &&
+        move.promotion_piece_type() != 0) {
+        return false;
+    }
 
-        // Para cada uma das 8 direções
-        for (int delta : deltas) {
-            int to_square = from_square;
-
-            // Vai deslizando na direção do delta
-            while (true) {
-                to_square += delta;
-
-                // Se ultrapassar os limites do tabuleiro, sai do loop
-                if (to_square < 0 || to_square >= 64) break;
-
-                // Evita dar a volta na borda do tabuleiro
-                // Mesma lógica que as torres e bispos
-                int from_file_of_step = (to_square - delta) % 8;
-                int to_file_of_step = to_square % 8;
-                // Um movimento diagonal, horizontal ou vertical válido
-                // não deve mudar a coluna em mais de 1 casa
-                if (std::abs(from_file_of_step - to_file_of_step) > 1) break;
-
-                // Cria uma máscara de bit para a casa de destino
-                uint64_t to_bit = (1ULL << to_square);
-
-                // Se a casa já estiver ocupada por uma peça preta,
-                // não pode mover para lá e sai do loop
-                if (board.black_occupied & to_bit) break;
-
-                // Se a casa já estiver ocupada por uma peça branca,
-                // adiciona o movimento e sai do loop
-                if (board.white_occupied & to_bit) {
-                    moves.push_back(Move(from_square, to_square));
-                    break;
-                }
-
-                // A casa está vazia, adiciona o movimento e continua deslizando
-                // na mesma direção
-                moves.push_back(Move(from_square, to_square));
+    // Roque e en passant são raros: basta gerá-los e procurar
+    if (move.type() == MoveType::CASTLING ||
+        move.type() == MoveType::EN_PASSANT) {
+        MoveList special;
+        if (move.type() == MoveType::CASTLING) {
+            if (type != KING ||
+                attackers_to<S::Them>(from, board, board.all_occupied)) {
+                return false;
             }
+            castling_moves<Us>(board, from, special);
+        } else if (type == PAWN) {
+            en_passant_moves<Us, false>(board, 0, special);
         }
-
-        queens &= queens - 1;  // Remove a dama processada do bitboard
+        for (const Move& candidate : special) {
+            if (candidate == move) return true;
+        }
+        return false;
     }
-    return moves;
-}
 
-// Gera todos os movimentos válidos para o jogador atual
-std::vector<Move> gen_all_moves(const Board& board) {
-    std::vector<Move> all_moves;  // Guarda todos os movimentos válidos
-    std::vector<Move> buffer;     // Guarda movimentos de peças individuais
+    if (type == PAWN) {
+        // Chegar na última fileira é promoção, e só isso é promoção
+        const bool promotion_rank = (to_bit & S::PROMOTION_RANK) != 0;
+        if (promotion_rank != (move.type() == MoveType::PROMOTION)) {
+            return false;
+        }
 
-    // Inicializa as tabelas de ataques se ainda não estiverem prontas
-    if (!table_attacks_ready) {
-        init_king_attacks();         // Ataques do rei
-        init_knight_attacks();       // Ataques dos cavalos
-        table_attacks_ready = true;  // Marca que as tabelas estão prontas
+        const uint64_t from_bit = 1ULL << from;
+        const uint64_t empty = ~board.all_occupied;
+        const uint64_t single_push = shift<S::UP>(from_bit) & empty;
+        const uint64_t double_push =
+            shift<S::UP>(single_push & S::DOUBLE_PUSH_RANK) & empty;
+        const uint64_t captures =
+            (shift<S::UP_RIGHT>(from_bit & NOT_H_FILE) |
+             shift<S::UP_LEFT>(from_bit & NOT_A_FILE)) &
+            board.occupied[S::Them];
+        return ((single_push | double_push | captures) & to_bit) != 0;
     }
 
-    // Gera o movimento o vetor de movimentos possíveis para o jogador atual
-    // Calcula o vetor de cada conjunto de peças individualmente e adiciona
-    // no vetor geral após isso
-    if (board.turn == WHITE) {
-        buffer = gen_white_pawn_moves(board);  // Peões brancos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
-
-        buffer = gen_white_king_moves(board);  // Rei branco
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+    if (move.type() != MoveType::NORMAL) return false;
+
+    uint64_t attacks = 0ULL;
+    switch (type) {
+        case KNIGHT:
+            attacks = knight_attacks[from];
+            break;
+        case BISHOP:
+            attacks = Attacks::bishop_attacks(from, board.all_occupied);
+            break;
+        case ROOK:
+            attacks = Attacks::rook_attacks(from, board.all_occupied);
+            break;
+        case QUEEN:
+            attacks = Attacks::queen_attacks(from, board.all_occupied);
+            break;
+        case KING:
+            attacks = king_attacks[from];
+            break;
+        default:
+            break;
+    }
+    return (attacks & to_bit) != 0;
+}
 
-        buffer = gen_white_knight_moves(board);  // Cavalos brancos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+template <Color Us>
+static bool is_legal(const Position& board, Move move) {
+    if (!is_pseudo_legal<Us>(board, move)) return false;
 
-        buffer = gen_white_rook_moves(board);  // Torres brancas
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+    // O roque já foi conferido por inteiro (o rei não passa por casa
+    // atacada). Os demais são aplicados em uma cópia para ver se o rei
+    // fica em xeque.
+    if (move.type() == MoveType::CASTLING) return true;
 
-        buffer = gen_white_bishop_moves(board);  // Bispos brancos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+    Position after = board;
+    after.apply_move(move);
+    const uint64_t king = after.pieces[Us][KING];
+    return king == 0 ||
+           !is_square_attacked<Side<Us>::Them>(get_lsb(king), after);
+}
 
-        buffer = gen_white_queen_moves(board);  // Damas brancas
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
-    } else {
-        buffer = gen_black_pawn_moves(board);  // Peões pretos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+bool is_legal(const Position& board, Move move) {
+    init_tables();
 
-        buffer = gen_black_king_moves(board);  // Rei preto
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+    return (board.turn == WHITE) ? is_legal<WHITE>(board, move)
+                                 : is_legal<BLACK>(board, move);
+}
 
-        buffer = gen_black_knight_moves(board);  // Cavalos pretos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+// Troca estática: simula a sequência de capturas na casa de destino, cada
+// lado recapturando com a peça menos valiosa, e permite a cada lado parar
+// quando continuar for pior. Só as ocupações mudam durante a simulação; as
+// peças que estavam atrás de outra (raios X) entram conforme a da frente sai.
+// Um peão que recaptura na última fileira promove (sempre a dama): ganha a
+// diferença para o peão e deixa uma dama na casa. Cravadas são ignoradas.
+int see(const Position& board, Move move) {
+    init_tables();
+
+    if (move.type() == MoveType::CASTLING) return 0;
+
+    const int from = move.from();
+    const int to = move.to();
+    const int* values = Eval::PIECE_VALUES;
+    const bool last_rank = to < 8 || to >= 56;
+
+    uint64_t occupied = board.all_occupied ^ (1ULL << from);
+
+    // Ganho imediato e valor da peça que fica na casa
+    int gain[32];
+    int on_square = values[type_of(board.piece_on(from))];
+    if (move.type() == MoveType::EN_PASSANT) {
+        gain[0] = values[PAWN];
+        occupied ^= 1ULL << (to + (board.turn == WHITE ? -8 : 8));
+    } else {
+        const Piece victim = board.piece_on(to);
+        gain[0] = (victim == NO_PIECE) ? 0 : values[type_of(victim)];
+    }
+    if (move.type() == MoveType::PROMOTION) {
+        on_square = values[KNIGHT + move.promotion_piece_type()];
+        gain[0] += on_square - values[PAWN];
+    }
 
-        buffer = gen_black_rook_moves(board);  // Torres pretas
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+    const uint64_t diagonal = board.pieces[WHITE][BISHOP] |
+                              board.pieces[BLACK][BISHOP] |
+                              board.pieces[WHITE][QUEEN] |
+                              board.pieces[BLACK][QUEEN];
+    const uint64_t straight = board.pieces[WHITE][ROOK] |
+                              board.pieces[BLACK][ROOK] |
+                              board.pieces[WHITE][QUEEN] |
+                              board.pieces[BLACK][QUEEN];
+
+    uint64_t attackers = (attackers_to<WHITE>(to, board, occupied) |
+                          attackers_to<BLACK>(to, board, occupied)) &
+                         occupied;
+
+    Color side = Color(board.turn ^ 1);
+    int depth = 0;
+    while (depth < 31) {
+        const uint64_t own = attackers & board.occupied[side];
+        if (!own) break;
+
+        // Atacante menos valioso do lado a capturar
+        int type = PAWN;
+        while (!(own & board.pieces[side][type])) ++type;
+
+        // O rei só captura se o outro lado não puder recapturar
+        if (type == KING && (attackers & board.occupied[side ^ 1])) break;
+
+        ++depth;
+        gain[depth] = on_square - gain[depth - 1];
+        on_square = values[type];
+        if (type == PAWN && last_rank) {
+            gain[depth] += values[QUEEN] - values[PAWN];
+            on_square = values[QUEEN];
+        }
 
-        buffer = gen_black_bishop_moves(board);  // Bispos pretos
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+        occupied ^= own & board.pieces[side][type] &
+                    -(own & board.pieces[side][type]);
+        attackers |= (Attacks::bishop_attacks(to, occupied) & diagonal) |
+                     (Attacks::rook_attacks(to, occupied) & straight);
+        attackers &= occupied;
 
-        buffer = gen_black_queen_moves(board);  // Damas pretas
-        all_moves.insert(all_moves.end(), buffer.begin(), buffer.end());
+        side = Color(side ^ 1);
     }
 
-    return all_moves;
+    // Volta pela sequência: cada lado escolhe entre capturar e parar
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+    return gain[0];
 }
 
-std::vector<Move> gen_legal_moves(Board& board) {
-    std::vector<Move> legal_moves;  // Guarda todos os movimentos legais
-
-    // Gera todos os movimentos pseudo-legais para o jogador atual.
-    std::vector<Move> pseudo_moves = gen_all_moves(board);
-
-    // Cor da do jogador que está movendo
-    const Color moving_player_color = board.turn;
-
-    // Itera sobre cada movimento pseudo-legal.
-    for (const Move& move : pseudo_moves) {
-        // Faz o movimento no tabuleiro.
-        board.make_move(move);
-
-        // Salva o estado do rei do jogador que moveu.
-        const uint64_t king_bitboard = (moving_player_color == WHITE)
-                                           ? board.white_king
-                                           : board.black_king;
-        const int king_square = get_lsb(king_bitboard);
-
-        // Se o rei não estiver atacado após o movimento,
-        // adiciona o movimento à lista de movimentos legais.
-        if (!is_square_attacked(king_square, board.turn, board)) {
-            legal_moves.push_back(move);
-        }
-
-        // Desfaz o movimento e segue para o próximo movimento.
-        board.undo_move();
-    }
+// Versões que retornam um vetor, para quem não está em um laço crítico
+std::vector<Move> gen_all_moves(const Position& board) {
+    MoveList moves;
+    gen_all_moves(board, moves);
+    return std::vector<Move>(moves.begin(), moves.end());
+}
 
-    return legal_moves;
+std::vector<Move> gen_legal_moves(const Position& board) {
+    MoveList moves;
+    gen_legal_moves(board, moves);
+    return std::vector<Move>(moves.begin(), moves.end());
 }
 
-}  // namespace MoveGen
\ No newline at end of file
+// Instancia os geradores das duas cores para uso fora deste arquivo
+template bool is_square_attacked<WHITE>(int, const Position&);
+template bool is_square_attacked<BLACK>(int, const Position&);
+template void gen_pawn_moves<WHITE>(const Position&, MoveList&);
+template void gen_pawn_moves<BLACK>(const Position&, MoveList&);
+template void gen_king_moves<WHITE>(const Position&, MoveList&);
+template void gen_king_moves<BLACK>(const Position&, MoveList&);
+template void gen_knight_moves<WHITE>(const Position&, MoveList&);
+template void gen_knight_moves<BLACK>(const Position&, MoveList&);
+template void gen_rook_moves<WHITE>(const Position&, MoveList&);
+template void gen_rook_moves<BLACK>(const Position&, MoveList&);
+template void gen_bishop_moves<WHITE>(const Position&, MoveList&);
+template void gen_bishop_moves<BLACK>(const Position&, MoveList&);
+template void gen_queen_moves<WHITE>(const Position&, MoveList&);
+template void gen_queen_moves<BLACK>(const Position&, MoveList&);
+
+}  // namespace MoveGen
@@ -0,0 +1,183 @@
+#include "pawns.h"
+
+namespace Pawns {
+
+// Penalidades e bônus em centipeões (meio-jogo, final)
+const int DOUBLED_MG = -10, DOUBLED_EG = -20;
+const int ISOLATED_MG = -10, ISOLATED_EG = -15;
+const int BACKWARD_MG = -8, BACKWARD_EG = -12;
+
+// Bônus do peão passado pela fileira, contada a partir do lado dele
+const int PASSED_MG[8] = {0, 5, 10, 15, 25, 45, 70, 0};
+const int PASSED_EG[8] = {0, 10, 15, 30, 50, 80, 120, 0};
+
+// Escudo do rei: peão próprio uma ou duas fileiras à frente do rei em cada
+// coluna ao lado dele, ou nenhum peão próprio à frente na coluna
+const int SHIELD_NEAR = 15;
+const int SHIELD_FAR = 8;
+const int SHIELD_MISSING = -20;
+
+const uint64_t FILE_A = 0x0101010101010101ULL;
+const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;
+const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;
+
+// Casas à frente (para a cor Us), incluindo as próprias casas
+template <Color Us>
+static inline uint64_t forward_fill(uint64_t bits) {
+    if (Us == WHITE) {
+        bits |= bits << 8;
+        bits |= bits << 16;
+        bits |= bits << 32;
+    } else {
+        bits |= bits >> 8;
+        bits |= bits >> 16;
+        bits |= bits >> 32;
+    }
+    return bits;
+}
+
+// Casas estritamente à frente
+template <Color Us>
+static inline uint64_t forward_span(uint64_t bits) {
+    return forward_fill<Us>(Us == WHITE ? bits << 8 : bits >> 8);
+}
+
+// Colunas vizinhas às das casas dadas
+static inline uint64_t adjacent_files(uint64_t bits) {
+    return ((bits & NOT_A_FILE) >> 1) | ((bits & NOT_H_FILE) << 1);
+}
+
+// Avalia os peões da cor Us, somando em mg e eg do ponto de vista de Us
+template <Color Us>
+static void evaluate_side(const Position& board, Entry& entry, int& mg,
+                          int& eg) {
+    constexpr Color Them = (Us == WHITE) ? BLACK : WHITE;
+    const uint64_t ours = board.pieces[Us][PAWN];
+    const uint64_t theirs = board.pieces[Them][PAWN];
+    const uint64_t their_attacks = pawn_attacks<Them>(theirs);
+
+    // Um peão que avança ataca as casas nas diagonais de todas as casas à
+    // frente dele
+    entry.attack_spans[Us] = pawn_attacks<Us>(forward_fill<Us>(ours));
+    entry.passed[Us] = 0;
+
+    uint64_t remaining = ours;
+    while (remaining) {
+        const int square = __builtin_ctzll(remaining);
+        remaining &= remaining - 1;
+
+        const uint64_t bit = 1ULL << square;
+        const uint64_t file = FILE_A << (square % 8);
+        const uint64_t front = forward_span<Us>(bit);
+        const uint64_t stop = (Us == WHITE) ? bit << 8 : bit >> 8;
+        const int relative_rank = (Us == WHITE) ? square / 8 : 7 - square / 8;
+
+        // Dobrado: outro peão próprio à frente na mesma coluna. Só o de
+        // trás é penalizado.
+        const bool doubled = ours & front;
+        const bool isolated = !(ours & adjacent_files(file));
+
+        // Atrasado: nenhum peão vizinho na mesma fileira ou atrás (que
+        // poderia apoiar o avanço) e a casa da frente atacada por um peão
+        // do oponente
+        const bool backward = !isolated &&
+                              !(stop & entry.attack_spans[Us]) &&
+                              (stop & their_attacks);
+
+        // Passado: nenhum peão do oponente à frente na mesma coluna ou nas
+        // vizinhas
+        const bool passed =
+            !doubled && !(theirs & (front | adjacent_files(front)));
+
+        if (doubled) {
+            mg += DOUBLED_MG;
+            eg += DOUBLED_EG;
+        }
+        if (isolated) {
+            mg += ISOLATED_MG;
+            eg += ISOLATED_EG;
+        }
+        if (backward) {
+            mg += BACKWARD_MG;
+            eg += BACKWARD_EG;
+        }
+        if (passed) {
+            mg += PASSED_MG[relative_rank];
+            eg += PASSED_EG[relative_rank];
+            entry.passed[Us] |= bit;
+        }
+    }
+}
+
+void evaluate(const Position& board, Entry& entry) {
+    int white_mg = 0, white_eg = 0, black_mg = 0, black_eg = 0;
+    evaluate_side<WHITE>(board, entry, white_mg, white_eg);
+    evaluate_side<BLACK>(board, entry, black_mg, black_eg);
+
+    entry.key = board.pawn_key;
+    entry.mg = int16_t(white_mg - black_mg);
+    entry.eg = int16_t(white_eg - black_eg);
+    entry.king_squares[WHITE] = entry.king_squares[BLACK] = NO_SQUARE;
+}
+
+// Soma, para cada coluna do rei e vizinhas, o peão próprio mais próximo à
+// frente do rei (até duas fileiras) ou a falta de peão na coluna
+template <Color Us>
+static int shield_score(const Position& board, int king_square) {
+    const uint64_t ours = board.pieces[Us][PAWN];
+    const int king_file = king_square % 8;
+    const int step = (Us == WHITE) ? 8 : -8;
+
+    int score = 0;
+    for (int file = king_file - 1; file <= king_file + 1; ++file) {
+        if (file < 0 || file > 7) continue;
+        const int square = king_square - king_file + file;
+        const int near = square + step;
+        const int far = square + 2 * step;
+
+        if (near >= 0 && near < 64 && (ours & (1ULL << near))) {
+            score += SHIELD_NEAR;
+        } else if (far >= 0 && far < 64 && (ours & (1ULL << far))) {
+            score += SHIELD_FAR;
+        } else if (!(ours & forward_span<Us>(1ULL << square))) {
+            score += SHIELD_MISSING;
+        }
+    }
+    return score;
+}
+
+int Entry::king_shield(Color color, const Position& board) {
+    const int king_square = __builtin_ctzll(board.pieces[color][KING]);
+    if (king_squares[color] != king_square) {
+        king_squares[color] = uint8_t(king_square);
+        shield[color] = int16_t(color == WHITE
+                                    ? shield_score<WHITE>(board, king_square)
+                                    : shield_score<BLACK>(board, king_square));
+    }
+    return shield[color];
+}
+
+// Entradas vazias têm chave 0, que também é a chave de uma posição sem
+// peões; como a estrutura vazia vale 0 e o escudo é recalculado
+// (king_squares inválidas), acertar uma entrada vazia dá o valor certo
+Table::Table(size_t entry_count) {
+    size_t size = 1;
+    while (size * 2 <= entry_count) size *= 2;
+    Entry empty{};
+    empty.king_squares[WHITE] = empty.king_squares[BLACK] = NO_SQUARE;
+    entries.assign(size, empty);
+    mask = size - 1;
+}
+
+Entry& Table::probe(const Position& board) {
+    ++probes;
+    Entry& entry = entries[board.pawn_key & mask];
+    if (entry.key == board.pawn_key) {
+        ++hits;
+        return entry;
+    }
+    evaluate(board, entry);
+    return entry;
+}
+
+}  // namespace Pawns
@@ -0,0 +1,436 @@
+#include "perft.h"
+
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "movegen.h"
+#include "utils.h"
+
+namespace Perft {
+
+PerftTable::PerftTable(size_t megabytes) {
+    // Maior potência de dois de entradas que cabe no tamanho pedido
+    const size_t bytes = megabytes * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= bytes) count *= 2;
+
+    // O () zera as entradas
+    entries.reset(new Entry[count]());
+    mask = count - 1;
+}
+
+bool PerftTable::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    const Entry* bucket = &entries[(key & mask) & ~size_t(1)];
+
+    for (int i = 0; i < 2; ++i) {
+        const uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        const uint64_t check =
+            bucket[i].check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && int(data & 0xFF) == depth) {
+            nodes = data >> 8;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PerftTable::store(uint64_t key, int depth, uint64_t nodes) {
+    // Cada balde tem duas entradas: a primeira só é trocada por subárvores
+    // pelo menos tão profundas (que economizam mais trabalho), a segunda
+    // recebe o que sobrar
+    Entry* bucket = &entries[(key & mask) & ~size_t(1)];
+    const uint64_t stored = bucket[0].data.load(std::memory_order_relaxed);
+    Entry& entry = (depth >= int(stored & 0xFF)) ? bucket[0] : bucket[1];
+
+    const uint64_t data = (nodes << 8) | uint64_t(depth);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+// Faz um movimento de gen_legal_moves. O tabuleiro só o recusaria com o
+// histórico cheio, e as funções públicas conferem o espaço antes de começar
+// (has_room): uma recusa aqui seria um erro de programação, não um motivo
+// para contar menos nós.
+static inline void make_legal_move(Board& board, const Move& move) {
+    const bool made = board.make_move(move);
+    assert(made);
+    (void)made;
+}
+
+// Confere se cabem no histórico os movimentos de uma contagem até a
+// profundidade dada (o último nível só é contado) e mostra o erro se não
+static bool has_room(const Board& board, int depth) {
+    if (board.free_plies() >= depth - 1) return true;
+    std::cerr << "Erro: histórico cheio, cabem só " << board.free_plies()
+              << " movimentos para perft de profundidade " << depth << "."
+              << std::endl;
+    return false;
+}
+
+static uint64_t count_nodes(Board& board, int depth, PerftTable* table) {
+    if (depth == 0) return 1;
+
+    // No último nível a contagem é barata, não vale consultar a tabela
+    uint64_t nodes = 0;
+    if (table && depth > 1 && table->probe(board.key, depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves;
+    MoveGen::gen_legal_moves(board, moves);
+
+    // Como os movimentos já são legais, no último nível basta contá-los
+    if (depth == 1) return moves.size();
+
+    for (const Move& move : moves) {
+        make_legal_move(board, move);
+        nodes += count_nodes(board, depth - 1, table);
+        board.undo_move();
+    }
+
+    if (table) table->store(board.key, depth, nodes);
+
+    return nodes;
+}
+
+uint64_t perft(Board& board, int depth, PerftTable* table) {
+    if (!has_room(board, depth)) return 0;
+    return count_nodes(board, depth, table);
+}
+
+static uint64_t perft_copy_make(PositionStack& stack, int depth) {
+    MoveList moves;
+    MoveGen::gen_legal_moves(stack.current(), moves);
+
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        stack.make_move(move);
+        nodes += perft_copy_make(stack, depth - 1);
+        stack.undo_move();
+    }
+
+    return nodes;
+}
+
+uint64_t perft_copy_make(const Position& root, int depth) {
+    if (depth == 0) return 1;
+
+    PositionStack stack(root);
+    return perft_copy_make(stack, depth);
+}
+
+// Maior número de movimentos a partir da raiz usado para dividir a árvore
+const int MAX_SPLIT_DEPTH = 4;
+
+// Quantas tarefas por thread criar antes de começar, para que as threads
+// que terminarem cedo tenham o que roubar
+const int TASKS_PER_THREAD = 16;
+
+// Subárvore a ser contada: a sequência de movimentos a partir da raiz e o
+// índice do movimento da raiz a que ela pertence
+struct Task {
+    Move path[MAX_SPLIT_DEPTH];
+    int length;
+    int root_index;
+};
+
+// Fila de tarefas de uma thread. A dona retira do fim e as outras threads,
+// quando ficam sem trabalho, roubam do começo.
+class TaskDeque {
+   public:
+    void push(const Task& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+
+    bool pop(Task& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(Task& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+   private:
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+// Divide a árvore em tarefas. Começa com uma tarefa por movimento da raiz e,
+// enquanto houver poucas tarefas, troca cada uma pelas suas filhas.
+static std::vector<Task> split_tasks(const Board& root, int depth,
+                                     const MoveList& root_moves,
+                                     int threads) {
+    std::vector<Task> tasks;
+    for (int i = 0; i < root_moves.size(); ++i) {
+        Task task;
+        task.path[0] = root_moves[i];
+        task.length = 1;
+        task.root_index = i;
+        tasks.push_back(task);
+    }
+
+    const size_t wanted = size_t(threads) * TASKS_PER_THREAD;
+    int length = 1;
+
+    // Cada subárvore precisa de pelo menos um nível para contar
+    while (tasks.size() < wanted && length < MAX_SPLIT_DEPTH &&
+           length < depth - 1) {
+        std::vector<Task> children;
+        Board board = root;
+
+        for (const Task& task : tasks) {
+            for (int i = 0; i < task.length; ++i) {
+                make_legal_move(board, task.path[i]);
+            }
+
+            // Posições sem movimentos (mate ou afogamento) não têm folhas
+            // na profundidade pedida e simplesmente somem
+            MoveList moves;
+            MoveGen::gen_legal_moves(board, moves);
+            for (const Move& move : moves) {
+                Task child = task;
+                child.path[child.length++] = move;
+                children.push_back(child);
+            }
+
+            for (int i = 0; i < task.length; ++i) {
+                board.undo_move();
+            }
+        }
+
+        tasks.swap(children);
+        length++;
+    }
+
+    return tasks;
+}
+
+std::vector<uint64_t> perft_parallel(const Board& board, int depth,
+                                     int threads, PerftTable* table) {
+    MoveList root_moves;
+    MoveGen::gen_legal_moves(board, root_moves);
+
+    std::vector<uint64_t> root_counts(root_moves.size(), 0);
+    if (depth < 1 || root_moves.empty() || !has_room(board, depth)) {
+        return root_counts;
+    }
+
+    if (threads < 1) threads = 1;
+    std::vector<Task> tasks = split_tasks(board, depth, root_moves, threads);
+
+    // Distribui as tarefas entre as filas das threads
+    std::vector<TaskDeque> queues(threads);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        queues[i % threads].push(tasks[i]);
+    }
+
+    // Cada thread soma as contagens em seu próprio vetor; a soma final é a
+    // mesma da versão sequencial, independente de quem contou o quê
+    std::vector<std::vector<uint64_t>> partial_counts(
+        threads, std::vector<uint64_t>(root_moves.size(), 0));
+
+    auto worker = [&](int id) {
+        Board local_board = board;  // Cada thread tem sua cópia
+        std::vector<uint64_t>& counts = partial_counts[id];
+        Task task;
+
+        while (true) {
+            // Primeiro a própria fila, depois tenta roubar das outras.
+            // Nenhuma tarefa nova é criada, então filas vazias = fim.
+            bool found = queues[id].pop(task);
+            for (int i = 1; !found && i < threads; ++i) {
+                found = queues[(id + i) % threads].steal(task);
+            }
+            if (!found) break;
+
+            for (int i = 0; i < task.length; ++i) {
+                make_legal_move(local_board, task.path[i]);
+            }
+            counts[task.root_index] +=
+                count_nodes(local_board, depth - task.length, table);
+            for (int i = 0; i < task.length; ++i) {
+                local_board.undo_move();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int id = 1; id < threads; ++id) {
+        pool.emplace_back(worker, id);
+    }
+    worker(0);  // A thread principal também trabalha
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    for (const std::vector<uint64_t>& counts : partial_counts) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            root_counts[i] += counts[i];
+        }
+    }
+
+    return root_counts;
+}
+
+uint64_t divide(Board& board, int depth, int threads, PerftTable* table) {
+    if (depth < 1) return 1;
+    if (!has_room(board, depth)) return 0;
+
+    MoveList moves;
+    MoveGen::gen_legal_moves(board, moves);
+
+    std::vector<uint64_t> counts(moves.size(), 0);
+    if (threads > 1) {
+        counts = perft_parallel(board, depth, threads, table);
+    } else {
+        for (int i = 0; i < moves.size(); ++i) {
+            make_legal_move(board, moves[i]);
+            counts[i] = count_nodes(board, depth - 1, table);
+            board.undo_move();
+        }
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+        std::cout << move_to_string(moves[i]) << ": " << counts[i]
+                  << std::endl;
+        total += counts[i];
+    }
+
+    std::cout << std::endl << "Movimentos: " << moves.size() << std::endl;
+    return total;
+}
+
+void run(Board& board, int depth, bool show_divide, int threads,
+         size_t hash_megabytes) {
+    MoveGen::init_tables();
+    if (!has_room(board, depth)) return;
+
+    std::unique_ptr<PerftTable> table;
+    if (hash_megabytes > 0) {
+        table.reset(new PerftTable(hash_megabytes));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t nodes = 0;
+    if (show_divide) {
+        nodes = divide(board, depth, threads, table.get());
+    } else if (threads > 1 && depth > 0) {
+        for (uint64_t count :
+             perft_parallel(board, depth, threads, table.get())) {
+            nodes += count;
+        }
+    } else {
+        nodes = perft(board, depth, table.get());
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Threads: " << threads << std::endl;
+    if (table) {
+        std::cout << "Hash: " << hash_megabytes << " MB (" << table->size()
+                  << " entradas)" << std::endl;
+    }
+    std::cout << "Nós: " << nodes << std::endl;
+    std::cout << "Tempo: " << seconds << " s" << std::endl;
+    if (seconds > 0) {
+        std::cout << "Nós/s: " << uint64_t(nodes / seconds) << std::endl;
+    }
+}
+
+// Posição de referência e contagem esperada para uma profundidade
+struct SuiteEntry {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t expected;
+};
+
+// Posições de referência usadas por outros motores, escolhidas para exercitar
+// roques, en passant, promoções e cravadas
+const char* const KIWIPETE =
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+const char* const POSITION_3 = "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1";
+const char* const POSITION_4 =
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1";
+const char* const POSITION_5 =
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8";
+const char* const POSITION_6 =
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
+
+// Contagens conhecidas
+static const SuiteEntry suite[] = {
+    {"inicial", START_FEN, 1, 20},
+    {"inicial", START_FEN, 2, 400},
+    {"inicial", START_FEN, 3, 8902},
+    {"inicial", START_FEN, 4, 197281},
+    {"inicial", START_FEN, 5, 4865609},
+    {"inicial", START_FEN, 6, 119060324},
+    {"kiwipete", KIWIPETE, 1, 48},
+    {"kiwipete", KIWIPETE, 2, 2039},
+    {"kiwipete", KIWIPETE, 3, 97862},
+    {"kiwipete", KIWIPETE, 4, 4085603},
+    {"posição 3", POSITION_3, 5, 674624},
+    {"posição 3", POSITION_3, 6, 11030083},
+    {"posição 4", POSITION_4, 4, 422333},
+    {"posição 4", POSITION_4, 5, 15833292},
+    {"posição 5", POSITION_5, 4, 2103487},
+    {"posição 6", POSITION_6, 4, 3894594},
+};
+
+bool run_suite() {
+    MoveGen::init_tables();
+
+    bool all_passed = true;
+    uint64_t total_nodes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const SuiteEntry& entry : suite) {
+        Board board;
+        board.from_fen(entry.fen);
+        uint64_t nodes = perft(board, entry.depth);
+        bool passed = (nodes == entry.expected);
+
+        std::cout << (passed ? "[ok]   " : "[erro] ") << entry.name
+                  << " profundidade " << entry.depth << ": " << nodes;
+        if (!passed) std::cout << " (esperado " << entry.expected << ")";
+        std::cout << std::endl;
+
+        all_passed = all_passed && passed;
+        total_nodes += nodes;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << std::endl << "Nós: " << total_nodes << std::endl;
+    std::cout << "Tempo: " << seconds << " s" << std::endl;
+    if (seconds > 0) {
+        std::cout << "Nós/s: " << uint64_t(total_nodes / seconds)
+                  << std::endl;
+    }
+
+    return all_passed;
+}
+
+}  // namespace Perft
@@ -0,0 +1,134 @@
+#include "psqt.h"
+
+namespace PSQT {
+
+// Bônus por casa para as brancas, escritos como o tabuleiro é visto: a
+// primeira linha é a oitava fileira (a8 a h8) e a última, a primeira
+// fileira (a1 a h1)
+static constexpr int PAWN_MG[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    10,  10,  20,  30,  30,  20,  10,  10,
+     5,   5,  10,  25,  25,  10,   5,   5,
+     0,   0,   0,  20,  20,   0,   0,   0,
+     5,  -5, -10,   0,   0, -10,  -5,   5,
+     5,  10,  10, -20, -20,  10,  10,   5,
+     0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+// No final o que importa no peão é o quanto ele avançou
+static constexpr int PAWN_EG[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    80,  80,  80,  80,  80,  80,  80,  80,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    30,  30,  30,  30,  30,  30,  30,  30,
+    15,  15,  15,  15,  15,  15,  15,  15,
+     5,   5,   5,   5,   5,   5,   5,   5,
+     0,   0,   0,   0,   0,   0,   0,   0,
+     0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+static constexpr int KNIGHT_SQUARES[64] = {
+   -50, -40, -30, -30, -30, -30, -40, -50,
+   -40, -20,   0,   0,   0,   0, -20, -40,
+   -30,   0,  10,  15,  15,  10,   0, -30,
+   -30,   5,  15,  20,  20,  15,   5, -30,
+   -30,   0,  15,  20,  20,  15,   0, -30,
+   -30,   5,  10,  15,  15,  10,   5, -30,
+   -40, -20,   0,   5,   5,   0, -20, -40,
+   -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+static constexpr int BISHOP_SQUARES[64] = {
+   -20, -10, -10, -10, -10, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,  10,  10,   5,   0, -10,
+   -10,   5,   5,  10,  10,   5,   5, -10,
+   -10,   0,  10,  10,  10,  10,   0, -10,
+   -10,  10,  10,  10,  10,  10,  10, -10,
+   -10,   5,   0,   0,   0,   0,   5, -10,
+   -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+static constexpr int ROOK_SQUARES[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+     5,  10,  10,  10,  10,  10,  10,   5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+     0,   0,   0,   5,   5,   0,   0,   0,
+};
+
+static constexpr int QUEEN_SQUARES[64] = {
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,   5,   5,   5,   0, -10,
+    -5,   0,   5,   5,   5,   5,   0,  -5,
+     0,   0,   5,   5,   5,   5,   0,  -5,
+   -10,   5,   5,   5,   5,   5,   0, -10,
+   -10,   0,   5,   0,   0,   0,   0, -10,
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+// No meio-jogo o rei fica protegido atrás dos peões, depois do roque
+static constexpr int KING_MG[64] = {
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -20, -30, -30, -40, -40, -30, -30, -20,
+   -10, -20, -20, -20, -20, -20, -20, -10,
+    20,  20,   0,   0,   0,   0,  20,  20,
+    20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+// No final o rei é uma peça de ataque e vai para o centro
+static constexpr int KING_EG[64] = {
+   -50, -40, -30, -20, -20, -30, -40, -50,
+   -30, -20, -10,   0,   0, -10, -20, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -30,   0,   0,   0,   0, -30, -30,
+   -50, -30, -30, -30, -30, -30, -30, -50,
+};
+
+static constexpr const int* MG_SQUARES[6] = {
+    PAWN_MG, KNIGHT_SQUARES, BISHOP_SQUARES, ROOK_SQUARES, QUEEN_SQUARES,
+    KING_MG};
+static constexpr const int* EG_SQUARES[6] = {
+    PAWN_EG, KNIGHT_SQUARES, BISHOP_SQUARES, ROOK_SQUARES, QUEEN_SQUARES,
+    KING_EG};
+
+static constexpr int PHASE_WEIGHTS[6] = {0, 1, 1, 2, 4, 0};
+
+// Junta material e bônus por casa para as 12 peças. As tabelas acima estão
+// na ordem visual, então a casa de uma peça branca é espelhada (square ^ 56);
+// a peça preta na casa espelhada vale o mesmo, com o sinal trocado.
+static constexpr Table make_table() {
+    Table result{};
+    for (int type = 0; type < 6; ++type) {
+        for (int square = 0; square < 64; ++square) {
+            const int white = type;
+            const int black = type + 6;
+            result.mg[white][square] = int16_t(
+                MG_VALUES[type] + MG_SQUARES[type][square ^ 56]);
+            result.eg[white][square] = int16_t(
+                EG_VALUES[type] + EG_SQUARES[type][square ^ 56]);
+            result.mg[black][square] =
+                int16_t(-MG_VALUES[type] - MG_SQUARES[type][square]);
+            result.eg[black][square] =
+                int16_t(-EG_VALUES[type] - EG_SQUARES[type][square]);
+        }
+        result.phase[type] = uint8_t(PHASE_WEIGHTS[type]);
+        result.phase[type + 6] = uint8_t(PHASE_WEIGHTS[type]);
+    }
+    return result;
+}
+
+constexpr Table table = make_table();
+
+}  // namespace PSQT
@@ -0,0 +1,690 @@
+#include "search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "eval.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "pawns.h"
+#include "utils.h"
+
+namespace Search {
+
+// A cada quantos nós o tempo é conferido
+const uint64_t TIME_CHECK_INTERVAL = 2048;
+
+// Folga da poda delta: uma captura que, somada a esta margem, ainda não leva
+// a avaliação até alfa não é buscada na quiescência
+const int DELTA_MARGIN = 200;
+
+// Técnicas seletivas (ver Selectivity). As margens são por unidade de
+// profundidade restante; as técnicas só valem até a profundidade indicada.
+// O razoring fica só no último nível: até a profundidade 3 ele descartava
+// sacrifícios e ameaças quietas e custava a maioria das posições táticas.
+const int RAZOR_DEPTH = 1;
+const int RAZOR_MARGIN = 300;
+const int REVERSE_FUTILITY_DEPTH = 6;
+const int REVERSE_FUTILITY_MARGIN = 100;
+const int FUTILITY_DEPTH = 3;
+const int FUTILITY_MARGIN = 150;
+
+// Movimento nulo: profundidade mínima e redução (R = base + prof / divisor)
+const int NULL_MOVE_DEPTH = 3;
+const int NULL_MOVE_BASE_REDUCTION = 3;
+const int NULL_MOVE_DEPTH_DIVISOR = 6;
+
+// LMR: profundidade mínima e quantos movimentos são buscados sem redução
+const int LMR_DEPTH = 3;
+const int LMR_FULL_MOVES = 3;
+
+// Bônus do histórico para um corte com a profundidade restante dada
+static inline int history_bonus(int depth) {
+    return std::min(depth * depth, 1200);
+}
+
+// Lazy SMP: as threads auxiliares pulam algumas profundidades, cada uma em
+// uma fase diferente, para que não busquem todas a mesma iteração ao mesmo
+// tempo. A auxiliar i usa a entrada (i - 1) % 20.
+const int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                           3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+const int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                            4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+class Worker;
+
+// Estado compartilhado pelas threads de uma busca. A tabela de transposição
+// é o único canal entre elas; fora isso, só a ordem de parar.
+struct Shared {
+    Shared(const Limits& limits, TranspositionTable& tt)
+        : limits(limits), tt(tt), stop(false), refused(false) {}
+
+    const Limits& limits;
+    TranspositionTable& tt;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> stop;
+
+    // Algum movimento foi recusado pelo tabuleiro; o erro é mostrado uma
+    // vez, no fim da busca
+    std::atomic<bool> refused;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    uint64_t total_nodes() const;
+};
+
+// Uma thread da busca, com sua cópia do tabuleiro, seus contadores e a
+// tabela triangular da variante principal (PV). pv[ply] guarda a melhor
+// sequência encontrada a partir daquele nível; ao achar um movimento melhor,
+// a linha do nível seguinte é copiada atrás dele. A thread 0 é a principal:
+// só ela confere o tempo e mostra as iterações.
+class Worker {
+   public:
+    Worker(const Board& root, Shared& shared, int id);
+
+    void run();
+
+    // Resultado e PV da última iteração completa
+    Result result;
+    Move best_pv[MAX_PLY];
+    int best_pv_length = 0;
+
+    // Contador lido pelas outras threads durante a busca. Só esta thread
+    // escreve, então load + store relaxados bastam (sem instrução atômica
+    // de leitura-modificação-escrita no caminho crítico).
+    std::atomic<uint64_t> nodes;
+
+    // Consultas e acertos na tabela de transposição
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;
+
+    // Cortes beta na busca principal e quantos vieram do primeiro movimento
+    uint64_t cutoffs = 0;
+    uint64_t first_move_cutoffs = 0;
+
+    // Tabela de peões desta thread (com as consultas e acertos)
+    Pawns::Table pawn_table;
+
+   private:
+    int negamax(int alpha, int beta, int depth, int ply);
+    int quiescence(int alpha, int beta, int ply);
+    void update_quiet_stats(Move move, int ply, int depth,
+                            const Move* quiets_tried, int quiet_count);
+    bool visit_node();
+    int refuse_move();
+    bool time_is_up() const;
+    bool skip_depth(int depth) const;
+
+    Board board;
+    Shared& shared;
+    TranspositionTable& tt;
+    const int id;
+
+    Move pv[MAX_PLY][MAX_PLY];
+    int pv_length[MAX_PLY];
+
+    // Enquanto a busca desce pela PV da iteração anterior (best_pv), o
+    // movimento dela é tentado primeiro em cada nível
+    bool follow_pv = false;
+
+    // Dois movimentos quietos que causaram corte em cada nível (killers),
+    // tentados logo depois das capturas nos outros nós do mesmo nível
+    Move killers[MAX_PLY][2];
+
+    // Movimento sendo buscado em cada nível (vazio para o movimento nulo)
+    Move played[MAX_PLY];
+
+    // Tabelas de ordenação desta thread: histórico dos quietos e
+    // contra-movimentos
+    ButterflyHistory history;
+    CounterMoveTable counter_moves;
+
+    // Redução da LMR por [profundidade][número do movimento], calculada a
+    // partir de Selectivity no início da busca
+    int reductions[64][64];
+};
+
+Worker::Worker(const Board& root, Shared& shared, int id)
+    : nodes(0), board(root), shared(shared), tt(shared.tt), id(id) {
+    const Selectivity& options = shared.limits.selectivity;
+    for (int depth = 0; depth < 64; ++depth) {
+        for (int move = 0; move < 64; ++move) {
+            reductions[depth][move] =
+                (depth == 0 || move == 0)
+                    ? 0
+                    : int(options.lmr_base + std::log(double(depth)) *
+                                                 std::log(double(move)) /
+                                                 options.lmr_divisor);
+        }
+    }
+}
+
+uint64_t Shared::total_nodes() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) {
+        total += worker->nodes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// Mates são guardados na tabela relativos ao nó (distância até o mate a
+// partir dele) e convertidos de volta para a distância a partir da raiz,
+// pois a mesma posição pode aparecer em níveis diferentes
+static inline int score_to_tt(int score, int ply) {
+    if (score > MATE_BOUND) return score + ply;
+    if (score < -MATE_BOUND) return score - ply;
+    return score;
+}
+
+static inline int score_from_tt(int score, int ply) {
+    if (score > MATE_BOUND) return score - ply;
+    if (score < -MATE_BOUND) return score + ply;
+    return score;
+}
+
+bool Worker::time_is_up() const {
+    if (shared.limits.movetime_ms <= 0) return false;
+    const auto elapsed = std::chrono::steady_clock::now() - shared.start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+               .count() >= shared.limits.movetime_ms;
+}
+
+bool Worker::skip_depth(int depth) const {
+    if (id == 0) return false;
+    const int i = (id - 1) % 20;
+    return ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2 != 0;
+}
+
+// Um movimento quieto que corta aqui provavelmente corta nos irmãos deste nó
+// também (killer), depois da mesma resposta do oponente (contra-movimento) e
+// em geral (histórico). Os quietos tentados antes dele perdem pontos.
+void Worker::update_quiet_stats(Move move, int ply, int depth,
+                                const Move* quiets_tried, int quiet_count) {
+    if (!(killers[ply][0] == move)) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    if (ply > 0 && !played[ply - 1].is_null()) {
+        const int previous_to = played[ply - 1].to();
+        counter_moves.set(board.piece_on(previous_to), previous_to, move);
+    }
+
+    const int bonus = history_bonus(depth);
+    for (int i = 0; i < quiet_count; ++i) {
+        const bool best = quiets_tried[i] == move;
+        history.update(board.turn, quiets_tried[i], best ? bonus : -bonus);
+    }
+}
+
+// Conta o nó e, na thread principal, confere o tempo de tempos em tempos.
+// Retorna true se a busca deve parar.
+inline bool Worker::visit_node() {
+    const uint64_t count = nodes.load(std::memory_order_relaxed) + 1;
+    nodes.store(count, std::memory_order_relaxed);
+
+    if (id == 0 && (((count % TIME_CHECK_INTERVAL) == 0 && time_is_up()) ||
+                    count == shared.limits.nodes)) {
+        shared.stop.store(true, std::memory_order_relaxed);
+    }
+    return shared.stop.load(std::memory_order_relaxed);
+}
+
+// Movimento recusado pelo tabuleiro (histórico cheio): a busca inteira
+// para, como no fim do tempo, e a iteração em andamento é descartada
+int Worker::refuse_move() {
+    shared.refused.store(true, std::memory_order_relaxed);
+    shared.stop.store(true, std::memory_order_relaxed);
+    return 0;
+}
+
+// Busca só capturas e promoções até a posição ficar quieta, para que a
+// avaliação não seja feita no meio de uma troca. O lado a mover pode parar
+// (stand pat) com a avaliação estática, exceto em xeque, quando todas as
+// respostas são buscadas.
+int Worker::quiescence(int alpha, int beta, int ply) {
+    pv_length[ply] = ply;
+
+    if (visit_node()) return 0;
+    if (ply >= MAX_PLY - 1) return Eval::evaluate(board, pawn_table);
+
+    const bool in_check = MoveGen::in_check(board);
+
+    int best_score = -INFINITE_SCORE;
+    int stand_pat = 0;
+    if (!in_check) {
+        stand_pat = Eval::evaluate(board, pawn_table);
+        if (stand_pat >= beta) return stand_pat;
+        if (stand_pat > alpha) alpha = stand_pat;
+        best_score = stand_pat;
+    }
+
+    // Fora do xeque, as capturas que perdem material (SEE < 0) nem são
+    // entregues pelo picker; em xeque, todas as evasões de uma vez
+    MovePicker picker = in_check ? MovePicker(board, Move(), &history)
+                                 : MovePicker(board, Move());
+
+    int move_count = 0;
+    for (Move move = picker.next(); !move.is_null(); move = picker.next()) {
+        ++move_count;
+
+        // Poda delta: nem ganhando a peça capturada com folga o lance
+        // alcança alfa
+        if (!in_check && move.type() != MoveType::PROMOTION) {
+            const Piece victim = board.piece_on(move.to());
+            const int gain = (victim == NO_PIECE)
+                                 ? Eval::PIECE_VALUES[PAWN]  // En passant
+                                 : Eval::PIECE_VALUES[type_of(victim)];
+            if (stand_pat + gain + DELTA_MARGIN <= alpha) continue;
+        }
+
+        if (!board.make_move(move)) return refuse_move();
+        const int score = -quiescence(-beta, -alpha, ply + 1);
+        board.undo_move();
+
+        if (shared.stop.load(std::memory_order_relaxed)) return 0;
+
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    // Em xeque e sem respostas: mate
+    if (in_check && move_count == 0) return -MATE_SCORE + ply;
+
+    return best_score;
+}
+
+int Worker::negamax(int alpha, int beta, int depth, int ply) {
+    pv_length[ply] = ply;
+
+    if (visit_node()) return 0;
+
+    // Empate por repetição ou pela regra dos 50 lances
+    if (ply > 0 && (board.halfmove_clock >= 100 || board.is_repetition())) {
+        return 0;
+    }
+
+    if (depth <= 0) return quiescence(alpha, beta, ply);
+    if (ply >= MAX_PLY - 1) return Eval::evaluate(board, pawn_table);
+
+    // Fora da PV, um resultado guardado com profundidade suficiente encerra
+    // o nó. Na PV o corte é evitado para não truncar a linha principal.
+    const bool pv_node = (beta - alpha) > 1;
+    TTEntry entry;
+    Move tt_move;
+    ++tt_probes;
+    if (tt.probe(board.key, entry)) {
+        ++tt_hits;
+        tt_move = entry.move;
+
+        if (!pv_node && entry.depth >= depth) {
+            const int tt_score = score_from_tt(entry.score, ply);
+            if (entry.bound == BOUND_EXACT ||
+                (entry.bound == BOUND_LOWER && tt_score >= beta) ||
+                (entry.bound == BOUND_UPPER && tt_score <= alpha)) {
+                return tt_score;
+            }
+        }
+    }
+
+    const Selectivity& options = shared.limits.selectivity;
+    const bool in_check = MoveGen::in_check(board);
+    const int static_eval =
+        in_check ? -INFINITE_SCORE : Eval::evaluate(board, pawn_table);
+
+    // Podas antes de olhar os movimentos, só fora da PV e do xeque
+    if (!pv_node && !in_check) {
+        // Razoring: perto das folhas e muito abaixo de alfa, só as capturas
+        // podem salvar o nó; se nem elas chegam a alfa, o nó é descartado
+        if (options.razoring && depth <= RAZOR_DEPTH &&
+            static_eval + RAZOR_MARGIN * depth < alpha) {
+            const int score = quiescence(alpha - 1, alpha, ply);
+            if (score < alpha) return score;
+        }
+
+        // Futilidade reversa: tão acima de beta que, mesmo perdendo a
+        // margem, o nó ainda cortaria
+        if (options.reverse_futility && depth <= REVERSE_FUTILITY_DEPTH &&
+            beta < MATE_BOUND &&
+            static_eval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+            return static_eval;
+        }
+
+        // Movimento nulo: se mesmo passando a vez a busca rasa fica acima de
+        // beta, um movimento de verdade certamente também ficaria. Fica de
+        // fora com só rei e peões (zugzwang) e logo depois de outro nulo.
+        const uint64_t pieces = board.occupied[board.turn] &
+                                ~(board.pieces[board.turn][PAWN] |
+                                  board.pieces[board.turn][KING]);
+        if (options.null_move && depth >= NULL_MOVE_DEPTH &&
+            static_eval >= beta && pieces &&
+            (ply == 0 || !played[ply - 1].is_null())) {
+            const int reduction =
+                NULL_MOVE_BASE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR;
+
+            played[ply] = Move();
+            follow_pv = false;
+            if (!board.make_null_move()) return refuse_move();
+            const int score =
+                -negamax(-beta, -beta + 1, depth - 1 - reduction, ply + 1);
+            board.undo_null_move();
+
+            if (shared.stop.load(std::memory_order_relaxed)) return 0;
+
+            // Um mate achado depois de passar a vez não é confiável
+            if (score >= beta) return (score > MATE_BOUND) ? beta : score;
+        }
+    }
+
+    // Poda de futilidade: nem o melhor quieto chegaria a alfa
+    const bool futile = options.futility && !pv_node && !in_check &&
+                        depth <= FUTILITY_DEPTH &&
+                        static_eval + FUTILITY_MARGIN * depth <= alpha;
+
+    // Contra-movimento da resposta anterior (a peça que acabou de mover
+    // está na casa de destino dela)
+    Move counter_move;
+    if (ply > 0 && !played[ply - 1].is_null()) {
+        const int previous_to = played[ply - 1].to();
+        counter_move =
+            counter_moves.get(board.piece_on(previous_to), previous_to);
+    }
+
+    // Na PV da iteração anterior, o movimento dela vem primeiro; fora dela,
+    // o movimento da tabela de transposição. Em xeque, as evasões são
+    // geradas de uma vez.
+    if (follow_pv) follow_pv = ply < best_pv_length;
+    const Move first_move = follow_pv ? best_pv[ply] : tt_move;
+    MovePicker picker =
+        in_check ? MovePicker(board, first_move, &history)
+                 : MovePicker(board, first_move, killers[ply], counter_move,
+                              &history);
+
+    // Quietos já buscados, que perdem pontos no histórico se outro cortar
+    Move quiets_tried[64];
+    int quiet_count = 0;
+
+    const int original_alpha = alpha;
+    int best_score = -INFINITE_SCORE;
+    Move best_move;
+    int move_count = 0;
+    for (Move move = picker.next(); !move.is_null(); move = picker.next()) {
+        const bool first = move_count++ == 0;
+
+        // Só o caminho do movimento da PV anterior continua nela
+        if (first && follow_pv) follow_pv = move == best_pv[ply];
+
+        const bool quiet = is_quiet(board, move);
+        played[ply] = move;
+        if (!board.make_move(move)) return refuse_move();
+
+        // O balde da próxima posição começa a vir para o cache enquanto os
+        // movimentos dela são gerados
+        tt.prefetch(board.key);
+
+        // Lances quietos que dão xeque não são podados nem reduzidos
+        const bool gives_check = !first && quiet && MoveGen::in_check(board);
+
+        if (futile && !first && quiet && !gives_check) {
+            board.undo_move();
+            best_score =
+                std::max(best_score, static_eval + FUTILITY_MARGIN * depth);
+            continue;
+        }
+
+        if (quiet && quiet_count < 64) quiets_tried[quiet_count++] = move;
+
+        int score;
+        if (first) {
+            // O primeiro movimento é buscado com a janela inteira
+            score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+        } else {
+            // Lances quietos tardios são buscados mais rasos; só voltam à
+            // profundidade normal se surpreenderem
+            int reduction = 0;
+            if (options.lmr && depth >= LMR_DEPTH &&
+                move_count > LMR_FULL_MOVES && quiet && !in_check &&
+                !gives_check) {
+                reduction = reductions[std::min(depth, 63)]
+                                      [std::min(move_count, 63)];
+                if (pv_node) --reduction;
+                reduction = std::max(0, std::min(reduction, depth - 2));
+            }
+
+            // Os demais com janela nula, só para provar que são piores. Se
+            // um deles surpreender, é buscado de novo com a janela inteira.
+            score = -negamax(-alpha - 1, -alpha, depth - 1 - reduction,
+                             ply + 1);
+            if (reduction > 0 && score > alpha) {
+                score = -negamax(-alpha - 1, -alpha, depth - 1, ply + 1);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+            }
+        }
+
+        board.undo_move();
+
+        // Só o caminho do primeiro filho pode continuar na PV anterior
+        follow_pv = false;
+
+        if (shared.stop.load(std::memory_order_relaxed)) return 0;
+
+        if (score > best_score) {
+            best_score = score;
+
+            if (score > alpha) {
+                alpha = score;
+                best_move = move;
+
+                // Novo melhor movimento: ele seguido da linha do filho
+                pv[ply][ply] = move;
+                for (int next = ply + 1; next < pv_length[ply + 1]; ++next) {
+                    pv[ply][next] = pv[ply + 1][next];
+                }
+                pv_length[ply] = pv_length[ply + 1];
+
+                if (alpha >= beta) {
+                    ++cutoffs;
+                    if (first) ++first_move_cutoffs;
+                    if (quiet) update_quiet_stats(move, ply, depth,
+                                                  quiets_tried, quiet_count);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Sem movimentos: mate (quanto mais perto, pior) ou afogamento
+    if (move_count == 0) {
+        return MoveGen::in_check(board) ? -MATE_SCORE + ply : 0;
+    }
+
+    const Bound bound = (best_score >= beta)            ? BOUND_LOWER
+                        : (best_score > original_alpha) ? BOUND_EXACT
+                                                        : BOUND_UPPER;
+    tt.store(board.key, best_move, score_to_tt(best_score, ply), depth, bound);
+
+    return best_score;
+}
+
+// Mostra o resultado de uma iteração em uma linha
+static void print_iteration(const Result& result, const Move* line,
+                            int length) {
+    std::cout << "profundidade " << result.depth << " score ";
+    if (result.score > MATE_BOUND) {
+        std::cout << "mate " << (MATE_SCORE - result.score + 1) / 2;
+    } else if (result.score < -MATE_BOUND) {
+        std::cout << "mate -" << (MATE_SCORE + result.score) / 2;
+    } else {
+        std::cout << result.score;
+    }
+    std::cout << " nós " << result.nodes << " nós/s "
+              << uint64_t(result.seconds > 0 ? result.nodes / result.seconds
+                                             : 0)
+              << " tempo " << result.seconds << " s tt "
+              << int(result.tt_hit_rate * 100) << "% cheia "
+              << result.hashfull << "‰ corte1 "
+              << int(result.first_move_cutoff_rate * 100) << "% peões "
+              << int(result.pawn_hit_rate * 100) << "% pv";
+    for (int i = 0; i < length; ++i) {
+        std::cout << " " << move_to_string(line[i]);
+    }
+    std::cout << std::endl;
+}
+
+void Worker::run() {
+    // Mesmo sem completar nenhuma iteração, há um movimento para jogar
+    MoveList root_moves;
+    MoveGen::gen_legal_moves(board, root_moves);
+    if (root_moves.empty()) return;
+    result.best_move = root_moves[0];
+
+    const Limits& limits = shared.limits;
+    for (int depth = 1; depth <= limits.depth && depth < MAX_PLY; ++depth) {
+        if (skip_depth(depth)) continue;
+
+        follow_pv = true;
+        const int score = negamax(-INFINITE_SCORE, INFINITE_SCORE, depth, 0);
+
+        // Uma iteração interrompida não é confiável
+        if (shared.stop.load(std::memory_order_relaxed)) break;
+
+        result.best_move = pv[0][0];
+        result.score = score;
+        result.depth = depth;
+
+        best_pv_length = pv_length[0];
+        for (int i = 0; i < best_pv_length; ++i) best_pv[i] = pv[0][i];
+
+        if (id == 0 && limits.verbose) {
+            Result report = result;
+            report.nodes = shared.total_nodes();
+            report.tt_hit_rate =
+                tt_probes ? double(tt_hits) / tt_probes : 0.0;
+            report.hashfull = tt.hashfull();
+            report.first_move_cutoff_rate =
+                cutoffs ? double(first_move_cutoffs) / cutoffs : 0.0;
+            report.pawn_hit_rate =
+                pawn_table.probes
+                    ? double(pawn_table.hits) / pawn_table.probes
+                    : 0.0;
+            report.seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() -
+                                 shared.start)
+                                 .count();
+            print_iteration(report, best_pv, best_pv_length);
+        }
+
+        // Um mate encontrado não muda com mais profundidade
+        if (score > MATE_BOUND || score < -MATE_BOUND) break;
+    }
+
+    // A thread principal terminou: as auxiliares param também
+    if (id == 0) shared.stop.store(true, std::memory_order_relaxed);
+}
+
+// Escolhe o resultado entre as threads por votação: cada thread vota no seu
+// melhor movimento com peso maior quanto mais profunda a iteração e melhor
+// a pontuação. O resultado é o da thread mais profunda entre as que
+// escolheram o movimento mais votado.
+static const Worker* vote(const Shared& shared) {
+    const auto& workers = shared.workers;
+
+    int min_score = INFINITE_SCORE;
+    for (const auto& worker : workers) {
+        if (worker->result.depth > 0) {
+            min_score = std::min(min_score, worker->result.score);
+        }
+    }
+
+    const Worker* best = workers[0].get();
+    int64_t best_votes = -1;
+    for (const auto& candidate : workers) {
+        if (candidate->result.depth == 0) continue;
+
+        int64_t votes = 0;
+        for (const auto& voter : workers) {
+            if (voter->result.depth > 0 &&
+                voter->result.best_move == candidate->result.best_move) {
+                votes += int64_t(voter->result.score - min_score + 14) *
+                         voter->result.depth;
+            }
+        }
+
+        if (votes > best_votes ||
+            (votes == best_votes &&
+             candidate->result.depth > best->result.depth)) {
+            best = candidate.get();
+            best_votes = votes;
+        }
+    }
+
+    return best;
+}
+
+Result run(const Board& board, const Limits& limits, TranspositionTable& tt) {
+    // As tabelas precisam estar prontas antes de as threads começarem; a
+    // partir daí elas só são lidas
+    MoveGen::init_tables();
+
+    Shared shared(limits, tt);
+    shared.start = std::chrono::steady_clock::now();
+    tt.new_search();
+
+    // Cada thread tem seu tabuleiro e suas tabelas de PV (MAX_PLY * MAX_PLY
+    // movimentos, grandes demais para a pilha)
+    const int threads = std::max(1, limits.threads);
+    for (int id = 0; id < threads; ++id) {
+        shared.workers.emplace_back(new Worker(board, shared, id));
+    }
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) {
+        helpers.emplace_back([&shared, id] { shared.workers[id]->run(); });
+    }
+    shared.workers[0]->run();
+    for (std::thread& helper : helpers) helper.join();
+
+    if (shared.refused.load(std::memory_order_relaxed)) {
+        std::cerr << "Erro: histórico cheio, a busca parou antes do limite."
+                  << std::endl;
+    }
+
+    Result result = vote(shared)->result;
+    result.nodes = shared.total_nodes();
+    result.hashfull = tt.hashfull();
+    result.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - shared.start)
+                         .count();
+
+    uint64_t probes = 0, hits = 0, cutoffs = 0, first_move_cutoffs = 0;
+    uint64_t pawn_probes = 0, pawn_hits = 0;
+    for (const auto& worker : shared.workers) {
+        probes += worker->tt_probes;
+        hits += worker->tt_hits;
+        cutoffs += worker->cutoffs;
+        first_move_cutoffs += worker->first_move_cutoffs;
+        pawn_probes += worker->pawn_table.probes;
+        pawn_hits += worker->pawn_table.hits;
+    }
+    result.tt_hit_rate = probes ? double(hits) / probes : 0.0;
+    result.first_move_cutoff_rate =
+        cutoffs ? double(first_move_cutoffs) / cutoffs : 0.0;
+    result.pawn_hit_rate = pawn_probes ? double(pawn_hits) / pawn_probes : 0.0;
+
+    return result;
+}
+
+}  // namespace Search
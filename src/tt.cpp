@@ -0,0 +1,168 @@
+#include "tt.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Os dados de uma entrada em 64 bits:
+//  0-15  movimento
+// 16-31  pontuação (com sinal)
+// 32-39  profundidade
+// 40-41  tipo do limite
+// 42-49  geração
+static inline uint64_t pack(Move move, int score, int depth, Bound bound,
+                            uint8_t generation) {
+    return uint64_t(move.raw()) | (uint64_t(uint16_t(int16_t(score))) << 16) |
+           (uint64_t(depth) << 32) | (uint64_t(bound) << 40) |
+           (uint64_t(generation) << 42);
+}
+
+static inline Move move_of(uint64_t data) {
+    return Move::from_raw(uint16_t(data));
+}
+static inline int score_of(uint64_t data) { return int16_t(data >> 16); }
+static inline int depth_of(uint64_t data) { return int(data >> 32) & 0xFF; }
+static inline Bound bound_of(uint64_t data) { return Bound((data >> 40) & 3); }
+static inline uint8_t generation_of(uint64_t data) {
+    return uint8_t(data >> 42);
+}
+
+// Um resultado da mesma posição só substitui o guardado se for exato ou se
+// não for mais raso do que ele por mais que isto. Assim uma busca reduzida
+// (LMR, janela nula) ou uma thread auxiliar numa profundidade menor não
+// apaga um resultado mais profundo.
+const int SAME_KEY_DEPTH_MARGIN = 2;
+
+// Tamanho de página grande no Linux
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+TranspositionTable::TranspositionTable(size_t megabytes, bool huge_pages)
+    : generation(0) {
+    // Maior potência de dois de baldes que cabe no tamanho pedido
+    const size_t bytes = megabytes * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes) count *= 2;
+
+    // Páginas grandes exigem alinhamento de 2 MB; aligned_alloc também
+    // exige que o tamanho seja múltiplo do alinhamento
+    size_t alignment = alignof(Bucket);
+    size_t allocation = count * sizeof(Bucket);
+    if (huge_pages && allocation >= HUGE_PAGE_SIZE) {
+        alignment = HUGE_PAGE_SIZE;
+    }
+    allocation = (allocation + alignment - 1) / alignment * alignment;
+
+    buckets = static_cast<Bucket*>(std::aligned_alloc(alignment, allocation));
+    if (!buckets) {
+        std::cerr << "Erro: não foi possível alocar a tabela de transposição ("
+                  << megabytes << " MB)" << std::endl;
+        std::exit(1);
+    }
+
+#ifdef __linux__
+    if (huge_pages && alignment == HUGE_PAGE_SIZE) {
+        madvise(buckets, allocation, MADV_HUGEPAGE);
+    }
+#endif
+
+    mask = count - 1;
+    clear();
+}
+
+TranspositionTable::~TranspositionTable() { std::free(buckets); }
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = buckets[key & mask];
+
+    for (const Entry& candidate : bucket.entries) {
+        const uint64_t data = candidate.data.load(std::memory_order_relaxed);
+        const uint64_t check =
+            candidate.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && bound_of(data) != BOUND_NONE) {
+            entry.move = move_of(data);
+            entry.score = score_of(data);
+            entry.depth = depth_of(data);
+            entry.bound = bound_of(data);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth,
+                               Bound bound) {
+    Bucket& bucket = buckets[key & mask];
+
+    // A própria posição, se já estiver no balde; senão, a entrada de menor
+    // valor: rasa e de buscas antigas
+    Entry* replace = nullptr;
+    int lowest_value = 0;
+    for (Entry& candidate : bucket.entries) {
+        const uint64_t data = candidate.data.load(std::memory_order_relaxed);
+        const uint64_t check =
+            candidate.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key) {
+            if (move.is_null()) move = move_of(data);
+
+            // Resultado mais raso: só renova a geração e o movimento
+            if (bound != BOUND_EXACT &&
+                depth + SAME_KEY_DEPTH_MARGIN < depth_of(data)) {
+                const uint64_t refreshed =
+                    pack(move, score_of(data), depth_of(data),
+                         bound_of(data), generation);
+                candidate.check.store(key ^ refreshed,
+                                      std::memory_order_relaxed);
+                candidate.data.store(refreshed, std::memory_order_relaxed);
+                return;
+            }
+
+            replace = &candidate;
+            break;
+        }
+
+        const int age = uint8_t(generation - generation_of(data));
+        const int value = depth_of(data) - 8 * age;
+        if (!replace || value < lowest_value) {
+            replace = &candidate;
+            lowest_value = value;
+        }
+    }
+
+    if (depth < 0) depth = 0;
+    if (depth > 255) depth = 255;
+
+    const uint64_t data = pack(move, score, depth, bound, generation);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    const size_t sample = (mask + 1 < 250) ? mask + 1 : 250;
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (bound_of(data) != BOUND_NONE &&
+                generation_of(data) == generation) {
+                ++used;
+            }
+        }
+    }
+    return int(used * 1000 / (sample * BUCKET_SIZE));
+}
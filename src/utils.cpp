@@ -0,0 +1,40 @@
+#include "utils.h"
+
+std::string square_to_algebraic(int square_index) {
+    if (square_index < 0 || square_index > 63) {
+        return "??";
+    }
+    char file_char = 'a' + (square_index % 8);
+    char rank_char = '1' + (square_index / 8);
+    std::string algebraic_notation = "";
+    algebraic_notation += file_char;
+    algebraic_notation += rank_char;
+    return algebraic_notation;
+}
+
+int algebraic_to_square(const std::string& square_notation) {
+    if (square_notation.length() != 2) {
+        return -1;
+    }
+    char file_char = square_notation[0];
+    char rank_char = square_notation[1];
+
+    if (file_char < 'a' || file_char > 'h' || rank_char < '1' ||
+        rank_char > '8') {
+        return -1;
+    }
+    int file_index = file_char - 'a';
+    int rank_index = rank_char - '1';
+    return rank_index * 8 + file_index;
+}
+
+std::string move_to_string(const Move& move) {
+    std::string text =
+        square_to_algebraic(move.from()) + square_to_algebraic(move.to());
+
+    // Promoções levam a letra da peça no final ("e7e8q")
+    if (move.type() == MoveType::PROMOTION) {
+        text += "nbrq"[move.promotion_piece_type()];
+    }
+    return text;
+}
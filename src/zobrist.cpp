@@ -0,0 +1,47 @@
+#include "zobrist.h"
+
+#include <mutex>
+
+namespace Zobrist {
+
+uint64_t piece_keys[2][6][64];
+uint64_t side_key;
+uint64_t castling_keys[16];
+uint64_t en_passant_keys[8];
+
+static std::once_flag keys_once;
+
+// Gerador pseudoaleatório (xorshift64*) com semente fixa, para que as chaves
+// sejam as mesmas a cada execução
+static uint64_t next_random(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+void init() {
+    std::call_once(keys_once, [] {
+        uint64_t state = 1070372ULL;
+
+        for (int color = 0; color < 2; ++color) {
+            for (int piece = 0; piece < 6; ++piece) {
+                for (int square = 0; square < 64; ++square) {
+                    piece_keys[color][piece][square] = next_random(state);
+                }
+            }
+        }
+
+        side_key = next_random(state);
+
+        for (int i = 0; i < 16; ++i) {
+            castling_keys[i] = next_random(state);
+        }
+
+        for (int file = 0; file < 8; ++file) {
+            en_passant_keys[file] = next_random(state);
+        }
+    });
+}
+
+}  // namespace Zobrist